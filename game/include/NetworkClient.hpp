@@ -1,5 +1,9 @@
 #pragma once
 
+#include "network/DeltaHistory.hpp"
+#include "network/Reassembler.hpp"
+#include "network/ReliableChannel.hpp"
+#include "network/SocketWaiter.hpp"
 #include "protocol/Protocol.hpp"
 
 #ifdef _WIN32
@@ -20,6 +24,7 @@ typedef int socklen_t;
 #include <cstdint>
 #include <cstring>
 #include <engine/gameplay/IScoreProvider.hpp>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <string>
@@ -37,6 +42,8 @@ struct ReceivedEntity {
   float hp_current;
   float hp_max;
   uint8_t player_slot;
+  // The server no longer has this entity; only entity_id is meaningful.
+  bool removed = false;
 };
 
 struct LobbyStatusSnapshot {
@@ -53,7 +60,7 @@ public:
   ~NetworkClient();
 
   bool connect(const std::string &server_ip, uint16_t port,
-               const std::string &player_name);
+               const std::string &player_name, uint32_t room_id = 0);
   void disconnect();
   bool isConnected() const { return _connected.load(); }
 
@@ -78,6 +85,11 @@ public:
 
   uint32_t getClientId() const { return _clientId.load(); }
   uint8_t getPlayerSlot() const { return _playerSlot.load(); }
+  uint32_t getRoomId() const { return _roomId.load(); }
+
+  // Fraction of real time the server simulation is advancing at; drops
+  // below 1 when the server is overloaded and skipping ticks.
+  float getServerTimeScale() const { return _serverTimeScale.load(); }
 
   std::unordered_map<uint32_t, PlayerScore> getPlayerScores() const;
 
@@ -95,15 +107,20 @@ public:
 private:
   void receiveLoop();
   void handlePacket(const uint8_t *data, size_t size);
+  void stampAcks(RType::Protocol::PacketHeader &header);
+  void flushAck(std::chrono::steady_clock::time_point now);
 
   int _sockfd;
   sockaddr_in _serverAddr;
 
   std::atomic<uint32_t> _clientId;
   std::atomic<uint8_t> _playerSlot;
+  std::atomic<uint32_t> _roomId;
+  std::atomic<float> _serverTimeScale;
   std::atomic<bool> _connected;
 
   std::thread _receiveThread;
+  std::unique_ptr<RType::Network::SocketWaiter> _waiter;
   std::atomic<bool> _running;
 
   std::queue<ReceivedEntity> _entityQueue;
@@ -125,6 +142,27 @@ private:
   mutable std::mutex _gameOverMutex;
 
   std::atomic<uint32_t> _sequence;
+  // Receive thread only; reset on every connect.
+  RType::Network::SequenceWindow _receivedReliable;
+  // Messages the server split over several datagrams; receive thread only.
+  RType::Network::Reassembler _reassembler;
+  // Game-state transitions, released in the order the server sent them.
+  RType::Network::ReliableUDP _ordered;
+  // Newest snapshot tick applied; older ones arriving late are dropped, as
+  // they could resurrect removed entities. Receive thread only.
+  uint32_t _snapshotTick;
+  bool _hasSnapshotTick;
+  // What each entity looked like in recent snapshots; snapshot entries
+  // only carry the fields that changed since one of them.
+  RType::Network::DeltaHistory<RType::Protocol::QuantizedEntityData,
+                               RType::Protocol::EntityDeltaData::HISTORY>
+      _entityHistory;
+  // Acks for the server's reliable packets ride on the next packet sent;
+  // the receive thread sends them on their own once _ackDue passes.
+  RType::Network::AckWindow _acks;
+  bool _ackPending;
+  std::chrono::steady_clock::time_point _ackDue;
+  std::mutex _ackMutex;
   std::chrono::steady_clock::time_point _lastHeartbeat;
   std::chrono::steady_clock::time_point _lastServerActivity;
   bool _soloMode;
@@ -8,7 +8,6 @@ namespace GameConstants {
     constexpr float LOGICAL_HEIGHT = 720.f;
 
     // ====== Network ======
-    constexpr float DESPAWN_TIMEOUT = 0.1f;
     constexpr float SERVER_TIMEOUT = 3.0f;  // Server considered dead after 3 seconds
     constexpr float HEARTBEAT_INTERVAL = 1.0f;
 
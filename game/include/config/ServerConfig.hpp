@@ -8,5 +8,6 @@ namespace Config {
         inline std::string IP = "127.0.0.1";
         inline uint16_t PORT = 4242;
         inline std::string PLAYER_NAME = "Player";
+        inline uint32_t ROOM_ID = 0;
     }
 }
\ No newline at end of file
@@ -11,14 +11,13 @@ enum class EnemyType;
 
 struct EntityInfo {
     EntityID id;
-    float lastSeen;
 };
 
 class NetworkEntityManager {
 public:
     explicit NetworkEntityManager(Registry& registry);
 
-    void update(float dt, NetworkClient& network);
+    void update(NetworkClient& network);
     void clearAll();
 
     void setLevelRenderer(ILevelRenderer* renderer) {
@@ -36,7 +35,6 @@ public:
 private:
     void spawnEntity(const ReceivedEntity& update);
     void updateEntity(const ReceivedEntity& update, EntityID localEntity);
-    void despawnTimedOutEntities(float dt);
     void spawnEnemyOfType(EntityID localEntity,
                           const ReceivedEntity& update,
                           EnemyType type,
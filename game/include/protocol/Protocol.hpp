@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 
@@ -29,16 +30,22 @@ enum class PacketType : uint8_t {
     ENTITY_FIRE = 0x25,
     PLAYER_DEATH = 0x26,
     GAME_EVENT = 0x27,
+    SNAPSHOT_ACK = 0x28,
     GAME_ON = 0x30,
     GAME_OFF = 0x31,
     GAME_OVER = 0x32,
     ACK = 0xE0,
+    FRAGMENT = 0xE1,
+    BUNDLE = 0xE2,
+    ORDERED = 0xE3,
     PING = 0xF0,
     PONG = 0xF1
 };
 
 enum class ReliabilityFlag : uint8_t {
     UNRELIABLE = 0x00,
+    COMPRESSED = 0x20,      // body after the header is Network::snapshotCodec() output
+    HAS_ACKS = 0x40,
     RELIABLE = 0x80
 };
 
@@ -69,14 +76,19 @@ inline EntityType fromEntityTypeId(uint8_t value) {
     return static_cast<EntityType>(value);
 }
 
+// ack and ack_bits acknowledge the reliable packets received from the
+// other side: ack is the newest sequence, bit n of ack_bits stands for
+// ack - 1 - n. They are only meaningful when HAS_ACKS is set.
 struct PacketHeader {
     uint16_t magic;
     PacketType type;
     uint16_t sequence_number;
     uint8_t flags;
+    uint16_t ack;
+    uint32_t ack_bits;
 
     PacketHeader() : magic(0xBEEF), type(PacketType::PING),
-                     sequence_number(0), flags(0) {}
+                     sequence_number(0), flags(0), ack(0), ack_bits(0) {}
                      
     bool isReliable() const { 
         return (flags & static_cast<uint8_t>(ReliabilityFlag::RELIABLE)) != 0; 
@@ -89,6 +101,20 @@ struct PacketHeader {
             flags &= ~static_cast<uint8_t>(ReliabilityFlag::RELIABLE);
         }
     }
+
+    bool hasAcks() const {
+        return (flags & static_cast<uint8_t>(ReliabilityFlag::HAS_ACKS)) != 0;
+    }
+
+    bool isCompressed() const {
+        return (flags & static_cast<uint8_t>(ReliabilityFlag::COMPRESSED)) != 0;
+    }
+
+    void setAcks(uint16_t latest, uint32_t bits) {
+        ack = latest;
+        ack_bits = bits;
+        flags |= static_cast<uint8_t>(ReliabilityFlag::HAS_ACKS);
+    }
 } PACKED;
 
 struct AckPacket {
@@ -100,12 +126,64 @@ struct AckPacket {
     }
 } PACKED;
 
+// One piece of a message larger than the MTU, followed by the bytes
+// [offset, offset + piece size) of that message. The message keeps its
+// own header; reliability is carried by the fragments.
+struct FragmentHeader {
+    PacketHeader header;
+    uint16_t message_id;
+    uint8_t fragment_index;
+    uint8_t fragment_count;
+    uint32_t total_size;
+    uint32_t offset;
+
+    FragmentHeader() : message_id(0), fragment_index(0), fragment_count(0),
+                       total_size(0), offset(0) {
+        header.type = PacketType::FRAGMENT;
+    }
+} PACKED;
+
+// Messages for one client packed into a single datagram: message_count
+// entries of a uint16_t length followed by that many bytes, each a complete
+// packet with its own header. Reliability is carried by the bundle.
+struct BundleHeader {
+    static constexpr size_t ENTRY_PREFIX = sizeof(uint16_t);
+
+    PacketHeader header;
+    uint8_t message_count;
+
+    BundleHeader() : message_count(0) {
+        header.type = PacketType::BUNDLE;
+    }
+} PACKED;
+
+// A message on the ordered channel, followed by the message itself. The
+// receiver hands messages on in order_sequence order (see
+// Network::ReliableUDP); the wrapper carries the reliability.
+struct OrderedHeader {
+    PacketHeader header;
+    uint16_t order_sequence;
+
+    OrderedHeader() : order_sequence(0) {
+        header.type = PacketType::ORDERED;
+        header.setReliable(true);
+    }
+} PACKED;
+
+// Optional features, offered by the client in ConnectRequest. The server
+// answers with the ones it will use in ConnectResponse.
+enum Capability : uint8_t {
+    CAPABILITY_SNAPSHOT_COMPRESSION = 0x01  // ENTITY_UPDATE bodies may be COMPRESSED
+};
+
 struct ConnectRequest {
     PacketHeader header;
     char client_version[16];
     char player_name[32];
+    uint32_t room_id;
+    uint8_t capabilities;   // Capability bits
     
-    ConnectRequest() {
+    ConnectRequest() : room_id(0), capabilities(0) {
         header.type = PacketType::CONNECT_REQUEST;
         header.setReliable(false);
         std::memset(client_version, 0, sizeof(client_version));
@@ -117,7 +195,8 @@ enum class ConnectionStatus : uint8_t {
     ACCEPTED = 0,
     REJECTED_FULL = 1,
     REJECTED_VERSION = 2,
-    REJECTED_BANNED = 3
+    REJECTED_BANNED = 3,
+    REJECTED_NO_ROOM = 4
 };
 
 struct ConnectResponse {
@@ -126,9 +205,11 @@ struct ConnectResponse {
     uint32_t client_id;
     uint8_t assigned_player_slot;
     char server_version[16];
+    uint32_t room_id;
+    uint8_t capabilities;   // Capability bits the server accepted
     
     ConnectResponse() : status(ConnectionStatus::ACCEPTED), 
-                        client_id(0), assigned_player_slot(0) {
+                        client_id(0), assigned_player_slot(0), room_id(0), capabilities(0) {
         header.type = PacketType::CONNECT_RESPONSE;
         header.setReliable(false);
         std::memset(server_version, 0, sizeof(server_version));
@@ -241,6 +322,27 @@ struct GameEvent {
         std::memset(levelName, 0, sizeof(levelName));
         std::memset(nextLevelName, 0, sizeof(nextLevelName));
     }
+
+    // Bit-packed body (see network/BitStream.hpp); sent through encode().
+    // Packed fields cannot bind to references, hence the locals.
+    template<typename Stream>
+    bool serialize(Stream& stream) {
+        auto type = static_cast<uint8_t>(event_type);
+        uint32_t entity = entityId;
+        uint32_t killer = killerId;
+        uint32_t score = scoreGain;
+        if (!stream.serializeInt(type, 0, static_cast<int64_t>(GameEventType::LEVEL_COMPLETE))
+            || !stream.serializeVarint(entity) || !stream.serializeVarint(killer)
+            || !stream.serializeVarint(score)
+            || !stream.serializeString(levelName, sizeof(levelName))
+            || !stream.serializeString(nextLevelName, sizeof(nextLevelName)))
+            return false;
+        event_type = static_cast<GameEventType>(type);
+        entityId = entity;
+        killerId = killer;
+        scoreGain = score;
+        return true;
+    }
 } PACKED;
 
 struct GameOn {
@@ -277,15 +379,42 @@ struct LobbyStatus {
     }
 } PACKED;
 
-struct ScoreUpdate {
-    PacketHeader header;
+struct PlayerScoreEntry {
     uint32_t client_id;
     uint32_t score;
     uint32_t enemies_killed;
-    
-    ScoreUpdate() : client_id(0), score(0), enemies_killed(0) {
+} PACKED;
+
+// Every player's score in one message per room, sent with each snapshot.
+// Bit-packed (see network/BitStream.hpp); only the first num_players
+// entries go on the wire.
+struct ScoreUpdate {
+    PacketHeader header;
+    uint8_t num_players;
+    PlayerScoreEntry players[4];
+
+    ScoreUpdate() : num_players(0), players{} {
         header.type = PacketType::SCORE_UPDATE;
     }
+
+    template<typename Stream>
+    bool serialize(Stream& stream) {
+        uint8_t count = num_players;
+        if (!stream.serializeInt(count, 0, 4))
+            return false;
+        num_players = count;
+        for (uint8_t i = 0; i < count; ++i) {
+            uint32_t id = players[i].client_id;
+            uint32_t score = players[i].score;
+            uint32_t kills = players[i].enemies_killed;
+            if (!stream.serializeVarint(id) || !stream.serializeVarint(score) || !stream.serializeVarint(kills))
+                return false;
+            players[i].client_id = id;
+            players[i].score = score;
+            players[i].enemies_killed = kills;
+        }
+        return true;
+    }
 } PACKED;
 
 struct PlayerFinalScore {
@@ -310,6 +439,29 @@ struct GameOver {
         header.type = PacketType::GAME_OVER;
         header.setReliable(true);
     }
+
+    // Only the first num_players entries go on the wire.
+    template<typename Stream>
+    bool serialize(Stream& stream) {
+        uint8_t count = num_players;
+        if (!stream.serializeInt(count, 0, 4))
+            return false;
+        num_players = count;
+        for (uint8_t i = 0; i < count; ++i) {
+            PlayerFinalScore& player = players[i];
+            uint32_t id = player.client_id;
+            uint32_t score = player.score;
+            uint32_t kills = player.enemies_killed;
+            if (!stream.serializeVarint(id)
+                || !stream.serializeString(player.player_name, sizeof(player.player_name))
+                || !stream.serializeVarint(score) || !stream.serializeVarint(kills))
+                return false;
+            player.client_id = id;
+            player.score = score;
+            player.enemies_killed = kills;
+        }
+        return true;
+    }
 } PACKED;
 
 // ============================================================================
@@ -350,7 +502,9 @@ enum EntityChangeMask : uint8_t {
     CHANGED_VELOCITY    = 0x02,  // vel_x, vel_y changed
     CHANGED_HP          = 0x04,  // hp_current, hp_max changed
     CHANGED_TYPE        = 0x08,  // entity_type changed (rare)
-    CHANGED_SLOT        = 0x10   // player_slot changed (rare)
+    CHANGED_SLOT        = 0x10,  // player_slot changed (rare)
+    CHANGED_ALL         = 0x1F,
+    ENTITY_REMOVED      = 0x20   // the client should drop the entity; no fields follow
 };
 
 // Quantized entity data (float 32bit -> int16)
@@ -371,28 +525,20 @@ struct QuantizedEntityData {
           hp_current(0), hp_max(0), entity_type(0), player_slot(255) {}
 } PACKED;
 
-// Batched entity update - Pack multiple entities in ONE packet
-// Reduces packet overhead by ~98% (50 packets -> 1 packet)
-struct BatchedEntityUpdate {
-    PacketHeader header;
-    uint16_t entity_count;  // Number of entities in this batch
-    QuantizedEntityData entities[64];  // Max 64 entities per packet
-
-    BatchedEntityUpdate() : entity_count(0), entities{} {
-        header.type = PacketType::ENTITY_UPDATE;
-    }
-
-    size_t getPacketSize() const {
-        return sizeof(PacketHeader) + sizeof(uint16_t) +
-               (entity_count * sizeof(QuantizedEntityData));
-    }
-} PACKED;
-
 // Delta compressed entity - Only send changed fields
 // Reduces bandwidth by ~70% by sending only what changed
+//
+// Fields missing from change_mask keep their value from the entity's state
+// baseline_age snapshots ago. Clients keep the last HISTORY states of each
+// entity, and the server only refers further back than that to the last
+// state it sent. A baseline_age of 0 means there is no baseline and every
+// field is present.
 struct EntityDeltaData {
+    static constexpr uint32_t HISTORY = 16;
+
     uint32_t entity_id;
     uint8_t change_mask;    // Bitmask of what changed (EntityChangeMask)
+    uint32_t baseline_age;
 
     // Optional fields (only present if corresponding bit in change_mask is set)
     int16_t pos_x;
@@ -405,9 +551,161 @@ struct EntityDeltaData {
     uint8_t player_slot;
 
     EntityDeltaData()
-        : entity_id(0), change_mask(0), pos_x(0), pos_y(0),
+        : entity_id(0), change_mask(0), baseline_age(0), pos_x(0), pos_y(0),
           vel_x(0), vel_y(0), hp_current(0), hp_max(0),
           entity_type(0), player_slot(255) {}
+
+    // Bit-packed (see network/BitStream.hpp). Packed fields cannot bind to
+    // references, hence the locals.
+    template<typename Stream>
+    bool serialize(Stream& stream) {
+        uint32_t id = entity_id;
+        uint8_t mask = change_mask;
+        if (!stream.serializeVarint(id) || !stream.serializeInt(mask, 0, CHANGED_ALL | ENTITY_REMOVED))
+            return false;
+        entity_id = id;
+        change_mask = mask;
+        if (mask & ENTITY_REMOVED)
+            return true;
+
+        uint32_t age = baseline_age;
+        if (!stream.serializeVarint(age))
+            return false;
+        baseline_age = age;
+
+        int16_t a = 0;
+        int16_t b = 0;
+        if (mask & CHANGED_POSITION) {
+            a = pos_x;
+            b = pos_y;
+            if (!stream.serializeInt(a, -32768, 32767) || !stream.serializeInt(b, -32768, 32767))
+                return false;
+            pos_x = a;
+            pos_y = b;
+        }
+        if (mask & CHANGED_VELOCITY) {
+            a = vel_x;
+            b = vel_y;
+            if (!stream.serializeInt(a, -32768, 32767) || !stream.serializeInt(b, -32768, 32767))
+                return false;
+            vel_x = a;
+            vel_y = b;
+        }
+        if (mask & CHANGED_HP) {
+            a = hp_current;
+            b = hp_max;
+            if (!stream.serializeInt(a, -32768, 32767) || !stream.serializeInt(b, -32768, 32767))
+                return false;
+            hp_current = a;
+            hp_max = b;
+        }
+        uint8_t byte = 0;
+        if (mask & CHANGED_TYPE) {
+            byte = entity_type;
+            if (!stream.serializeInt(byte, 0, 255))
+                return false;
+            entity_type = byte;
+        }
+        if (mask & CHANGED_SLOT) {
+            byte = player_slot;
+            if (!stream.serializeInt(byte, 0, 255))
+                return false;
+            player_slot = byte;
+        }
+        return true;
+    }
+} PACKED;
+
+// Overwrites the fields of state that delta carries.
+inline void applyEntityDelta(QuantizedEntityData& state, const EntityDeltaData& delta) {
+    if (delta.change_mask & CHANGED_POSITION) {
+        state.pos_x = delta.pos_x;
+        state.pos_y = delta.pos_y;
+    }
+    if (delta.change_mask & CHANGED_VELOCITY) {
+        state.vel_x = delta.vel_x;
+        state.vel_y = delta.vel_y;
+    }
+    if (delta.change_mask & CHANGED_HP) {
+        state.hp_current = delta.hp_current;
+        state.hp_max = delta.hp_max;
+    }
+    if (delta.change_mask & CHANGED_TYPE) {
+        state.entity_type = delta.entity_type;
+    }
+    if (delta.change_mask & CHANGED_SLOT) {
+        state.player_slot = delta.player_slot;
+    }
+}
+
+// Batched entity update - Pack multiple entities in ONE packet
+// Reduces packet overhead by ~98% (50 packets -> 1 packet)
+// One per client per snapshot tick, bit-packed after the header. Entries
+// are deltas against what the client acknowledged (SnapshotAck), so
+// unchanged entities are left out and despawns are ENTITY_REMOVED entries.
+struct BatchedEntityUpdate {
+    static constexpr uint16_t MAX_ENTITIES = 128;
+
+    PacketHeader header;
+    uint16_t entity_count;  // Number of entities in this batch
+    uint8_t time_scale;     // Simulation speed in percent of real time (100 = no dilation)
+    uint32_t tick;          // Snapshot tick, echoed back in SnapshotAck
+    EntityDeltaData entities[MAX_ENTITIES];
+
+    BatchedEntityUpdate() : entity_count(0), time_scale(100), tick(0), entities{} {
+        header.type = PacketType::ENTITY_UPDATE;
+    }
+
+    // Only the first entity_count entries go on the wire.
+    template<typename Stream>
+    bool serialize(Stream& stream) {
+        uint16_t count = entity_count;
+        uint8_t scale = time_scale;
+        uint32_t snapshotTick = tick;
+        if (!stream.serializeInt(count, 0, MAX_ENTITIES) || !stream.serializeInt(scale, 0, 255)
+            || !stream.serializeBits(snapshotTick, 32))
+            return false;
+        entity_count = count;
+        time_scale = scale;
+        tick = snapshotTick;
+        for (uint16_t i = 0; i < count; ++i) {
+            if (!entities[i].serialize(stream))
+                return false;
+        }
+        return true;
+    }
+} PACKED;
+
+// Client -> server: the newest snapshot tick applied. Unreliable; a lost
+// ack only means the next snapshots repeat a little more. Entities whose
+// delta could not be applied, because the client no longer had the state
+// it was based on, are listed in resync_ids; the server then sends them
+// whole. Only the used ids go on the wire (see getPacketSize()).
+struct SnapshotAck {
+    static constexpr uint8_t MAX_RESYNC = 16;
+
+    PacketHeader header;
+    uint32_t tick;
+    uint8_t resync_count;
+    uint32_t resync_ids[MAX_RESYNC];
+
+    SnapshotAck() : tick(0), resync_count(0), resync_ids{} {
+        header.type = PacketType::SNAPSHOT_ACK;
+    }
+
+    bool addResync(uint32_t entity_id) {
+        if (resync_count >= MAX_RESYNC)
+            return false;
+        resync_ids[resync_count++] = entity_id;
+        return true;
+    }
+
+    size_t getPacketSize() const {
+        uint8_t count = resync_count < MAX_RESYNC ? resync_count : MAX_RESYNC;
+        return PREFIX_SIZE + count * sizeof(uint32_t);
+    }
+
+    static constexpr size_t PREFIX_SIZE = sizeof(PacketHeader) + sizeof(uint32_t) + sizeof(uint8_t);
 } PACKED;
 
 inline bool IsValidPacket(const PacketHeader& header) {
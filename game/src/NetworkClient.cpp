@@ -1,5 +1,8 @@
 #include "NetworkClient.hpp"
+#include "network/BitStream.hpp"
+#include "network/SnapshotCodec.hpp"
 #include "protocol/Protocol.hpp"
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <iostream>
@@ -11,7 +14,6 @@ typedef int ssize_t;
 #endif
 
 static constexpr auto CONNECT_TIMEOUT = std::chrono::seconds(5);
-static constexpr auto RECEIVE_SLEEP = std::chrono::milliseconds(1);
 static constexpr auto HEARTBEAT_INTERVAL = std::chrono::seconds(2);
 static constexpr auto SERVER_TIMEOUT = std::chrono::seconds(10);
 
@@ -62,12 +64,15 @@ NetworkClient::NetworkClient()
     : _sockfd(-1)
     , _clientId(0)
     , _playerSlot(0)
+    , _roomId(0)
+    , _serverTimeScale(1.0f)
     , _connected(false)
     , _running(false)
     , _hasLobbyStatus(false)
     , _gameOn(false)
     , _gameOver(false)
     , _sequence(0)
+    , _ackPending(false)
     , _lastHeartbeat(std::chrono::steady_clock::now())
     , _lastServerActivity(std::chrono::steady_clock::now())
     , _soloMode(false)
@@ -87,7 +92,7 @@ NetworkClient::~NetworkClient() {
 }
 
 bool NetworkClient::connect(const std::string &server_ip, uint16_t port,
-                            const std::string &player_name) {
+                            const std::string &player_name, uint32_t room_id) {
   sockaddr_in from_addr{};
   socklen_t from_len = sizeof(from_addr);
   ssize_t received = 0;
@@ -123,11 +128,24 @@ bool NetworkClient::connect(const std::string &server_ip, uint16_t port,
     return false;
   }
 
+  _receivedReliable = RType::Network::SequenceWindow();
+  _reassembler = RType::Network::Reassembler();
+  _ordered = RType::Network::ReliableUDP();
+  _snapshotTick = 0;
+  _hasSnapshotTick = false;
+  _entityHistory.clear();
+  {
+    std::lock_guard<std::mutex> lock(_ackMutex);
+    _acks = RType::Network::AckWindow();
+    _ackPending = false;
+  }
   request.header.sequence_number = _sequence++;
   std::strncpy(request.client_version, "1.0.0",
                sizeof(request.client_version) - 1);
   std::strncpy(request.player_name, player_name.c_str(),
                sizeof(request.player_name) - 1);
+  request.room_id = room_id;
+  request.capabilities = RType::Protocol::CAPABILITY_SNAPSHOT_COMPRESSION;
 
   if (!sendPacket(_sockfd, _serverAddr, &request, sizeof(request))) {
     std::cerr << "[NetworkClient] Failed to send connect request" << std::endl;
@@ -183,7 +201,9 @@ bool NetworkClient::connect(const std::string &server_ip, uint16_t port,
   }
 
   if (response.status != RType::Protocol::ConnectionStatus::ACCEPTED) {
-    std::cerr << "[NetworkClient] Connection rejected" << std::endl;
+    std::cerr << "[NetworkClient] Connection rejected (status "
+              << (int)response.status << ", room " << response.room_id << ")"
+              << std::endl;
 #ifdef _WIN32
     ::closesocket(_sockfd);
     _sockfd = INVALID_SOCKET;
@@ -195,6 +215,7 @@ bool NetworkClient::connect(const std::string &server_ip, uint16_t port,
   }
   _clientId = response.client_id;
   _playerSlot = response.assigned_player_slot;
+  _roomId = response.room_id;
   _connected = true;
   _hasLobbyStatus = false;
   _gameOn = false;
@@ -202,11 +223,19 @@ bool NetworkClient::connect(const std::string &server_ip, uint16_t port,
   _lastHeartbeat = std::chrono::steady_clock::now();
   _lastServerActivity = std::chrono::steady_clock::now();
 
+  try {
+    _waiter = std::make_unique<RType::Network::SocketWaiter>(_sockfd);
+  } catch (const std::exception &e) {
+    std::cerr << "[NetworkClient] " << e.what() << std::endl;
+    _connected = false;
+    return false;
+  }
+
   _running = true;
   _receiveThread = std::thread(&NetworkClient::receiveLoop, this);
 
   std::cout << "[NetworkClient] Connected! Client ID: " << _clientId
-            << std::endl;
+            << " Room: " << _roomId << std::endl;
 
   return true;
 }
@@ -219,6 +248,7 @@ void NetworkClient::disconnect() {
   RType::Protocol::DisconnectPacket packet;
   packet.client_id = _clientId;
   packet.reason = 0;
+  stampAcks(packet.header);
   sendPacket(_sockfd, _serverAddr, &packet, sizeof(packet));
 
   std::this_thread::sleep_for(std::chrono::milliseconds(50));
@@ -228,9 +258,13 @@ void NetworkClient::disconnect() {
   _hasLobbyStatus = false;
   _gameOn = false;
 
+  if (_waiter) {
+    _waiter->wake();
+  }
   if (_receiveThread.joinable()) {
     _receiveThread.join();
   }
+  _waiter.reset();
 
 #ifdef _WIN32
   if (_sockfd != INVALID_SOCKET) {
@@ -256,6 +290,7 @@ void NetworkClient::sendInput(uint8_t input_flags) {
   input.client_id = _clientId;
   input.input_flags = input_flags;
   input.timestamp = 0;
+  stampAcks(input.header);
 
   sendPacket(_sockfd, _serverAddr, &input, sizeof(input));
 }
@@ -269,10 +304,32 @@ void NetworkClient::sendReady(bool ready) {
   packet.header.sequence_number = _sequence++;
   packet.client_id = _clientId;
   packet.ready = ready ? 1 : 0;
+  stampAcks(packet.header);
 
   sendPacket(_sockfd, _serverAddr, &packet, sizeof(packet));
 }
 
+void NetworkClient::stampAcks(RType::Protocol::PacketHeader &header) {
+  std::lock_guard<std::mutex> lock(_ackMutex);
+  if (_acks.valid) {
+    header.setAcks(_acks.ack, _acks.bits);
+    _ackPending = false;
+  }
+}
+
+void NetworkClient::flushAck(std::chrono::steady_clock::time_point now) {
+  RType::Protocol::AckPacket ack;
+  {
+    std::lock_guard<std::mutex> lock(_ackMutex);
+    if (!_ackPending || now < _ackDue) {
+      return;
+    }
+    ack.ack_sequence = _acks.ack;
+  }
+  stampAcks(ack.header);
+  sendPacket(_sockfd, _serverAddr, &ack, sizeof(ack));
+}
+
 LobbyStatusSnapshot NetworkClient::getLobbyStatus() const {
   std::lock_guard<std::mutex> lock(_lobbyMutex);
   return _lobbyStatus;
@@ -338,6 +395,7 @@ void NetworkClient::receiveLoop() {
       RType::Protocol::PacketHeader ping;
       ping.type = RType::Protocol::PacketType::PING;
       ping.sequence_number = _sequence++;
+      stampAcks(ping);
       sendPacket(_sockfd, _serverAddr, &ping, sizeof(ping));
       _lastHeartbeat = now;
       std::cout << "[NetworkClient] Sent heartbeat ping" << std::endl;
@@ -360,24 +418,46 @@ void NetworkClient::receiveLoop() {
       }
     }
 
-    sockaddr_in from_addr{};
-    socklen_t from_len = sizeof(from_addr);
+    flushAck(now);
+    // Ordered messages stuck behind a gap the server gave up on are
+    // released even if no more ordered traffic follows.
+    _ordered.poll(now, [this](const uint8_t* message, size_t length) { handlePacket(message, length); });
+
+    // Block until a packet arrives, the next heartbeat, ack flush or gap
+    // skip is due, or disconnect() wakes us, then drain everything that is
+    // queued.
+    auto wakeAt = std::min(_lastHeartbeat + HEARTBEAT_INTERVAL, _ordered.gapDeadline());
+    {
+      std::lock_guard<std::mutex> lock(_ackMutex);
+      if (_ackPending) {
+        wakeAt = std::min(wakeAt, _ackDue);
+      }
+    }
+    auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(
+        wakeAt - now + std::chrono::microseconds(999));
+    if (!_waiter->wait(std::max(timeout, std::chrono::milliseconds(0)))) {
+      continue;
+    }
+
+    while (_running) {
+      sockaddr_in from_addr{};
+      socklen_t from_len = sizeof(from_addr);
 
 #ifdef _WIN32
-    ssize_t received =
-        recvfrom(_sockfd, (char *)buffer.data(), (int)buffer.size(), 0,
-                 (struct sockaddr *)&from_addr, &from_len);
+      ssize_t received =
+          recvfrom(_sockfd, (char *)buffer.data(), (int)buffer.size(), 0,
+                   (struct sockaddr *)&from_addr, &from_len);
 #else
-    ssize_t received = recvfrom(_sockfd, buffer.data(), buffer.size(), 0,
-                                (struct sockaddr *)&from_addr, &from_len);
+      ssize_t received = recvfrom(_sockfd, buffer.data(), buffer.size(), 0,
+                                  (struct sockaddr *)&from_addr, &from_len);
 #endif
 
-    if (received > 0) {
-      _lastServerActivity = now;
+      if (received <= 0) {
+        break;
+      }
+      _lastServerActivity = std::chrono::steady_clock::now();
       handlePacket(buffer.data(), static_cast<size_t>(received));
     }
-
-    std::this_thread::sleep_for(RECEIVE_SLEEP);
   }
 }
 
@@ -393,57 +473,186 @@ void NetworkClient::handlePacket(const uint8_t* data, size_t size)
     if (!RType::Protocol::IsValidPacket(header)) {
         return;
     }
+
+    // The server retransmits reliable packets until they are acked; a
+    // retransmit of one already handled is acked again and dropped. Acks
+    // normally ride on the next outgoing packet (see flushAck).
+    if (header.isReliable()) {
+        bool inWindow;
+        {
+            std::lock_guard<std::mutex> lock(_ackMutex);
+            inWindow = _acks.record(header.sequence_number);
+            if (inWindow && !_ackPending) {
+                _ackPending = true;
+                _ackDue = std::chrono::steady_clock::now() + RType::Network::AckWindow::FLUSH_DELAY;
+            }
+        }
+        if (!inWindow) {
+            RType::Protocol::AckPacket ack;
+            ack.ack_sequence = header.sequence_number;
+            sendPacket(_sockfd, _serverAddr, &ack, sizeof(ack));
+        }
+        if (_receivedReliable.contains(header.sequence_number)) {
+            return;
+        }
+        _receivedReliable.insert(header.sequence_number);
+    }
+
+    // Messages larger than the server's MTU arrive in fragments; the
+    // rebuilt message is handled as if it had come in one datagram.
+    if (header.type == RType::Protocol::PacketType::FRAGMENT) {
+        if (size < sizeof(RType::Protocol::FragmentHeader)) {
+            return;
+        }
+        RType::Protocol::FragmentHeader fragmentHeader;
+        std::memcpy(&fragmentHeader, data, sizeof(fragmentHeader));
+        RType::Network::Reassembler::Fragment fragment{
+            fragmentHeader.message_id, fragmentHeader.fragment_index,
+            fragmentHeader.fragment_count, fragmentHeader.total_size,
+            fragmentHeader.offset, data + sizeof(fragmentHeader),
+            size - sizeof(fragmentHeader)};
+        const auto* message = _reassembler.add(RType::Network::Endpoint(), fragment,
+                                               std::chrono::steady_clock::now());
+        if (message) {
+            std::vector<uint8_t> whole(*message);
+            handlePacket(whole.data(), whole.size());
+        }
+        return;
+    }
+
+    if (header.type == RType::Protocol::PacketType::ORDERED) {
+        if (size < sizeof(RType::Protocol::OrderedHeader)) {
+            return;
+        }
+        RType::Protocol::OrderedHeader ordered;
+        std::memcpy(&ordered, data, sizeof(ordered));
+        _ordered.receive(ordered.order_sequence, data + sizeof(ordered), size - sizeof(ordered),
+                         std::chrono::steady_clock::now(),
+                         [this](const uint8_t* message, size_t length) { handlePacket(message, length); });
+        return;
+    }
+
+    // Everything the server had for us in one tick, packed together.
+    if (header.type == RType::Protocol::PacketType::BUNDLE) {
+        if (size < sizeof(RType::Protocol::BundleHeader)) {
+            return;
+        }
+        RType::Protocol::BundleHeader bundle;
+        std::memcpy(&bundle, data, sizeof(bundle));
+        size_t offset = sizeof(bundle);
+        for (uint8_t i = 0; i < bundle.message_count; ++i) {
+            uint16_t length = 0;
+            if (size - offset < sizeof(length)) {
+                break;
+            }
+            std::memcpy(&length, data + offset, sizeof(length));
+            offset += sizeof(length);
+            if (length > size - offset) {
+                break;
+            }
+            handlePacket(data + offset, length);
+            offset += length;
+        }
+        return;
+    }
     
     switch (header.type) {
 case RType::Protocol::PacketType::ENTITY_UPDATE: {
 
-    if (size >= sizeof(RType::Protocol::PacketHeader) + sizeof(uint16_t)) {
-        uint16_t entity_count = 0;
-        std::memcpy(&entity_count, data + sizeof(RType::Protocol::PacketHeader), sizeof(uint16_t));
-
-        if (entity_count > 0 && entity_count <= 64) {
-            size_t expected_size = sizeof(RType::Protocol::PacketHeader) + sizeof(uint16_t) +
-                                  (entity_count * sizeof(RType::Protocol::QuantizedEntityData));
-
-            if (size >= expected_size) {
-                const uint8_t* entity_data = data + sizeof(RType::Protocol::PacketHeader) + sizeof(uint16_t);
-
-                std::lock_guard<std::mutex> lock(_queueMutex);
-
-                static int bossUpdateCounter = 0;
-
-                for (uint16_t i = 0; i < entity_count; ++i) {
-                    RType::Protocol::QuantizedEntityData qdata;
-                    std::memcpy(&qdata, entity_data + (i * sizeof(RType::Protocol::QuantizedEntityData)),
-                               sizeof(RType::Protocol::QuantizedEntityData));
-
-                    ReceivedEntity entity;
-                    entity.entity_id = qdata.entity_id;
-                    entity.pos_x = RType::Protocol::dequantizePosition(qdata.pos_x);
-                    entity.pos_y = RType::Protocol::dequantizePosition(qdata.pos_y);
-                    entity.vel_x = RType::Protocol::dequantizeVelocity(qdata.vel_x);
-                    entity.vel_y = RType::Protocol::dequantizeVelocity(qdata.vel_y);
-                    entity.hp_current = RType::Protocol::dequantizeHP(qdata.hp_current);
-                    entity.hp_max = RType::Protocol::dequantizeHP(qdata.hp_max);
-                    entity.entity_type = qdata.entity_type;
-                    entity.player_slot = qdata.player_slot;
-
-                    if (entity.entity_type == 5) {
-                        if (bossUpdateCounter % 60 == 0) {
-                            std::cout << "[NetworkClient] Boss BATCHED_UPDATE received: ID=" << entity.entity_id
-                                      << " Type=" << (int)entity.entity_type
-                                      << " Pos=(" << entity.pos_x << "," << entity.pos_y << ")"
-                                      << " HP=" << entity.hp_current << "/" << entity.hp_max << std::endl;
-                        }
-                        bossUpdateCounter++;
-                    }
+    // A compressed snapshot is inflated back to its bit-packed form first.
+    RType::Network::EncodedPacket<sizeof(RType::Protocol::BatchedEntityUpdate)> inflated;
+    const uint8_t* snapshot = data;
+    size_t snapshotSize = size;
+    if (header.isCompressed()) {
+        if (!RType::Network::decompressBody(data, size, sizeof(header), inflated)) {
+            break;
+        }
+        snapshot = inflated.bytes;
+        snapshotSize = inflated.size;
+    }
+
+    RType::Protocol::BatchedEntityUpdate batch;
+    if (RType::Network::decode(snapshot, snapshotSize, batch)) {
+        uint32_t tick = batch.tick;
+        if (_hasSnapshotTick && static_cast<int32_t>(tick - _snapshotTick) <= 0) {
+            break;
+        }
+        _snapshotTick = tick;
+        _hasSnapshotTick = true;
+
+        _serverTimeScale.store(std::clamp(batch.time_scale, uint8_t(1), uint8_t(100)) / 100.0f);
+
+        // Tells the server this tick is now our baseline.
+        RType::Protocol::SnapshotAck ack;
+        ack.tick = tick;
+        bool missingBase = false;
 
+        {
+            std::lock_guard<std::mutex> lock(_queueMutex);
+
+            static int bossUpdateCounter = 0;
+
+            for (uint16_t i = 0; i < batch.entity_count; ++i) {
+                const RType::Protocol::EntityDeltaData& delta = batch.entities[i];
+
+                ReceivedEntity entity;
+                entity.entity_id = delta.entity_id;
+                if (delta.change_mask & RType::Protocol::ENTITY_REMOVED) {
+                    _entityHistory.erase(delta.entity_id);
+                    entity.removed = true;
                     _entityQueue.push(entity);
+                    continue;
                 }
 
-                break;
+                // Missing fields come from the state baseline_age ticks ago.
+                RType::Protocol::QuantizedEntityData qdata;
+                if (delta.baseline_age != 0) {
+                    const auto* base = _entityHistory.find(delta.entity_id, tick - delta.baseline_age);
+                    if (!base) {
+                        // Acking the tick would make the server take this
+                        // delta as applied; ask for the whole state instead.
+                        if (!ack.addResync(delta.entity_id)) {
+                            missingBase = true;
+                        }
+                        continue;
+                    }
+                    qdata = *base;
+                }
+                qdata.entity_id = delta.entity_id;
+                RType::Protocol::applyEntityDelta(qdata, delta);
+                _entityHistory.record(delta.entity_id, tick, qdata);
+
+                entity.pos_x = RType::Protocol::dequantizePosition(qdata.pos_x);
+                entity.pos_y = RType::Protocol::dequantizePosition(qdata.pos_y);
+                entity.vel_x = RType::Protocol::dequantizeVelocity(qdata.vel_x);
+                entity.vel_y = RType::Protocol::dequantizeVelocity(qdata.vel_y);
+                entity.hp_current = RType::Protocol::dequantizeHP(qdata.hp_current);
+                entity.hp_max = RType::Protocol::dequantizeHP(qdata.hp_max);
+                entity.entity_type = qdata.entity_type;
+                entity.player_slot = qdata.player_slot;
+
+                if (entity.entity_type == 5) {
+                    if (bossUpdateCounter % 60 == 0) {
+                        std::cout << "[NetworkClient] Boss BATCHED_UPDATE received: ID=" << entity.entity_id
+                                  << " Type=" << (int)entity.entity_type
+                                  << " Pos=(" << entity.pos_x << "," << entity.pos_y << ")"
+                                  << " HP=" << entity.hp_current << "/" << entity.hp_max << std::endl;
+                    }
+                    bossUpdateCounter++;
+                }
+
+                _entityQueue.push(entity);
             }
         }
+
+        // Too many misses to list: leave the tick unacked. The server keeps
+        // repeating what it sent and falls back to whole states.
+        if (!missingBase) {
+            ack.header.sequence_number = _sequence++;
+            stampAcks(ack.header);
+            sendPacket(_sockfd, _serverAddr, &ack, ack.getPacketSize());
+        }
+        break;
     }
 
     if (size >= sizeof(RType::Protocol::EntityUpdate)) {
@@ -538,10 +747,8 @@ case RType::Protocol::PacketType::ENTITY_UPDATE: {
   }
 
   case RType::Protocol::PacketType::GAME_EVENT: {
-    if (size >= sizeof(RType::Protocol::GameEvent)) {
-      RType::Protocol::GameEvent evt;
-      std::memcpy(&evt, data, sizeof(RType::Protocol::GameEvent));
-
+    RType::Protocol::GameEvent evt;
+    if (RType::Network::decode(data, size, evt)) {
       std::lock_guard<std::mutex> lock(_queueMutex);
       _gameEventQueue.push(evt);
 
@@ -580,22 +787,21 @@ case RType::Protocol::PacketType::ENTITY_UPDATE: {
   }
 
   case RType::Protocol::PacketType::SCORE_UPDATE: {
-    if (size >= sizeof(RType::Protocol::ScoreUpdate)) {
-      RType::Protocol::ScoreUpdate update;
-      std::memcpy(&update, data, sizeof(RType::Protocol::ScoreUpdate));
-
+    RType::Protocol::ScoreUpdate update;
+    if (RType::Network::decode(data, size, update)) {
       std::lock_guard<std::mutex> lock(_scoreMutex);
-      _playerScores[update.client_id] = {update.client_id, update.score,
-                                         update.enemies_killed};
+      for (uint8_t i = 0; i < update.num_players; ++i) {
+        const auto &entry = update.players[i];
+        _playerScores[entry.client_id] = {entry.client_id, entry.score,
+                                          entry.enemies_killed};
+      }
     }
     break;
   }
 
   case RType::Protocol::PacketType::GAME_OVER: {
-    if (size >= sizeof(RType::Protocol::GameOver)) {
-      RType::Protocol::GameOver packet;
-      std::memcpy(&packet, data, sizeof(RType::Protocol::GameOver));
-
+    RType::Protocol::GameOver packet;
+    if (RType::Network::decode(data, size, packet)) {
       std::lock_guard<std::mutex> lock(_gameOverMutex);
       _gameOver = true;
       _finalScores.clear();
@@ -614,6 +820,7 @@ case RType::Protocol::PacketType::ENTITY_UPDATE: {
     RType::Protocol::PacketHeader pong;
     pong.type = RType::Protocol::PacketType::PONG;
     pong.sequence_number = header.sequence_number;
+    stampAcks(pong);
 
     sendPacket(_sockfd, _serverAddr, &pong, sizeof(pong));
     break;
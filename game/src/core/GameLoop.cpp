@@ -390,7 +390,11 @@ void GameLoop::processGameLogic(float dt) {
     _network.sendInput(flags);
   }
 
-  _entityManager->update(dt, _network);
+  _entityManager->update(_network);
+
+  // While the server dilates time to catch up, its entities move slower
+  // than real time; run local animation and movement at the same rate.
+  const float simDt = isConnected ? dt * _network.getServerTimeScale() : dt;
 
   auto fireEvents = _network.pollFireEvents();
   for (const auto &event : fireEvents) {
@@ -401,12 +405,12 @@ void GameLoop::processGameLogic(float dt) {
     const auto &frames = getEnemyBasicFrames();
     if (!frames.empty()) {
       _registry.each<Enemy, Animation, Sprite>(
-          [dt, &frames](EntityID, Enemy &enemy, Animation &anim,
-                        Sprite &sprite) {
+          [simDt, &frames](EntityID, Enemy &enemy, Animation &anim,
+                           Sprite &sprite) {
             if (enemy.type != EnemyType::Basic)
               return;
 
-            anim.elapsedTime += dt;
+            anim.elapsedTime += simDt;
             if (anim.elapsedTime >= anim.frameTime) {
               anim.elapsedTime = 0.f;
 
@@ -436,12 +440,12 @@ void GameLoop::processGameLogic(float dt) {
     const auto &frames = getBossFrames();
     if (!frames.empty()) {
       _registry.each<Enemy, Animation, Sprite>(
-          [dt, &frames](EntityID, Enemy &enemy, Animation &anim,
-                        Sprite &sprite) {
+          [simDt, &frames](EntityID, Enemy &enemy, Animation &anim,
+                           Sprite &sprite) {
             if (enemy.type != EnemyType::Boss)
               return;
 
-            anim.elapsedTime += dt;
+            anim.elapsedTime += simDt;
             if (anim.elapsedTime >= anim.frameTime) {
               anim.elapsedTime = 0.f;
               int frameCount = static_cast<int>(frames.size());
@@ -462,11 +466,12 @@ void GameLoop::processGameLogic(float dt) {
     const auto &frames = getBossShotFrames();
     if (!frames.empty()) {
       _registry.each<Animation, Sprite>(
-          [dt, &frames, this](EntityID id, Animation &anim, Sprite &sprite) {
+          [simDt, &frames, this](EntityID id, Animation &anim,
+                                 Sprite &sprite) {
             if (_registry.has<Enemy>(id))
               return;
 
-            anim.elapsedTime += dt;
+            anim.elapsedTime += simDt;
             if (anim.elapsedTime >= anim.frameTime) {
               anim.elapsedTime = 0.f;
               int frameCount = static_cast<int>(frames.size());
@@ -484,7 +489,7 @@ void GameLoop::processGameLogic(float dt) {
   }
 
   for (auto &sys : _systems) {
-    sys->update(_registry, dt);
+    sys->update(_registry, simDt);
   }
 }
 
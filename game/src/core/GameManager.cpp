@@ -67,7 +67,8 @@ void GameManager::runGameSession(bool isSoloMode) {
                       
             if (!network.connect(Config::Server::IP, 
                                 Config::Server::PORT, 
-                                Config::Server::PLAYER_NAME)) {
+                                Config::Server::PLAYER_NAME,
+                                Config::Server::ROOM_ID)) {
                 std::cerr << "Failed to connect to server!" << std::endl;
                 shouldReturnToMenu = true;
                 break;
@@ -19,7 +19,7 @@ NetworkEntityManager::NetworkEntityManager(Registry& registry)
 {
 }
 
-void NetworkEntityManager::update(float dt, NetworkClient& network) {
+void NetworkEntityManager::update(NetworkClient& network) {
 
     if (network.isSoloMode()) {
         return;
@@ -27,26 +27,29 @@ void NetworkEntityManager::update(float dt, NetworkClient& network) {
     
     auto updates = network.pollEntityUpdates();
 
+    // Snapshots only carry what changed, so an entity stays until the
+    // server says it is gone.
     for (const auto& update : updates) {
         auto it = _networkEntities.find(update.entity_id);
 
-        if (it == _networkEntities.end()) {
+        if (update.removed) {
+            if (it != _networkEntities.end()) {
+                _registry.markForDestruction(it->second.id);
+                _networkEntities.erase(it);
+            }
+        } else if (it == _networkEntities.end()) {
             spawnEntity(update);
         } else {
             updateEntity(update, it->second.id);
         }
     }
-
-    if (network.isServerResponding()) {
-        despawnTimedOutEntities(dt);
-    }
 }
 
 void NetworkEntityManager::spawnEntity(const ReceivedEntity& update) {
     using namespace GameConstants;
     
     EntityID local_entity = _registry.create();
-    _networkEntities[update.entity_id] = { local_entity, 0.f };
+    _networkEntities[update.entity_id] = { local_entity };
     
     _registry.add<Transform>(local_entity, update.pos_x, update.pos_y);
     
@@ -262,11 +265,6 @@ const char* NetworkEntityManager::getEnemyTypeName(EnemyType type) const {
 void NetworkEntityManager::updateEntity(const ReceivedEntity& update, EntityID localEntity) {
     using namespace GameConstants;
     
-    auto it = _networkEntities.find(update.entity_id);
-    if (it != _networkEntities.end()) {
-        it->second.lastSeen = 0.f;
-    }
-    
     if (_registry.has<Transform>(localEntity)) {
         Transform& transform = _registry.get<Transform>(localEntity);
         transform.x = update.pos_x;
@@ -288,20 +286,6 @@ void NetworkEntityManager::updateEntity(const ReceivedEntity& update, EntityID l
     }
 }
 
-void NetworkEntityManager::despawnTimedOutEntities(float dt) {
-    using namespace GameConstants;
-    
-    for (auto it = _networkEntities.begin(); it != _networkEntities.end(); ) {
-        it->second.lastSeen += dt;
-        if (it->second.lastSeen > DESPAWN_TIMEOUT) {
-            _registry.markForDestruction(it->second.id);
-            it = _networkEntities.erase(it);
-        } else {
-            ++it;
-        }
-    }
-}
-
 void NetworkEntityManager::clearAll() {
     for (auto& [net_id, info] : _networkEntities) {
         _registry.markForDestruction(info.id);
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "SimulatedClient.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace RType::LoadGen {
+
+struct LoadConfig {
+    std::string host = "127.0.0.1";
+    uint16_t port = 4242;
+    uint32_t clients = 200;
+    uint32_t threads = 4;
+    uint32_t players_per_room = 4;
+    uint32_t room_base = 1000;
+    std::chrono::seconds duration{30};
+    std::chrono::milliseconds ramp_up{2000};
+    bool compression = true;
+    std::string train_output;   // where to write snapshot byte frequencies, if set
+};
+
+// Drives a swarm of SimulatedClients over loopback, one poll() loop per
+// thread, and prints a capacity report when the run is over.
+class LoadGenerator {
+public:
+    explicit LoadGenerator(LoadConfig config);
+
+    int run();
+    void requestStop() { _stopRequested = true; }
+
+private:
+    void workerLoop(size_t index, std::vector<std::unique_ptr<SimulatedClient>>& clients);
+    void report(const std::vector<std::vector<std::unique_ptr<SimulatedClient>>>& shards,
+                std::chrono::duration<double> elapsed) const;
+
+    LoadConfig _config;
+    std::atomic<bool> _stopRequested;
+};
+
+} // namespace RType::LoadGen
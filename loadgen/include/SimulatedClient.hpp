@@ -0,0 +1,102 @@
+#pragma once
+
+#include "network/Reassembler.hpp"
+#include "network/ReliableChannel.hpp"
+#include "protocol/Protocol.hpp"
+#include <netinet/in.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace RType::LoadGen {
+
+struct ClientStats {
+    uint64_t packets_received = 0;
+    uint64_t bytes_received = 0;
+    uint64_t bytes_sent = 0;
+    uint64_t snapshots = 0;
+    uint64_t inputs_sent = 0;
+    uint64_t connect_retries = 0;
+    // Snapshot bodies after the header, as received and once decompressed.
+    uint64_t snapshot_wire_bytes = 0;
+    uint64_t snapshot_body_bytes = 0;
+    std::array<uint64_t, 256> snapshot_byte_counts{};
+    std::vector<double> inter_arrival_ms;
+    std::vector<double> rtt_ms;
+};
+
+// One headless player: connects to a room, readies up, then plays a
+// scripted input pattern while recording what it receives.
+class SimulatedClient {
+public:
+    using clock = std::chrono::steady_clock;
+
+    enum class State {
+        CONNECTING,
+        LOBBY,
+        PLAYING,
+        REJECTED
+    };
+
+    SimulatedClient(uint32_t index, uint32_t room_id, const sockaddr_in& server, bool compression);
+    ~SimulatedClient();
+
+    SimulatedClient(const SimulatedClient&) = delete;
+    SimulatedClient& operator=(const SimulatedClient&) = delete;
+
+    bool open();
+    void update(clock::time_point now);
+    void drain(clock::time_point now);
+    void disconnect();
+
+    int getFd() const { return _fd; }
+    State getState() const { return _state; }
+    const ClientStats& getStats() const { return _stats; }
+
+private:
+    void send(const void* data, size_t size);
+    void sendConnect();
+    void sendInput(clock::time_point now);
+    void sendPing(clock::time_point now);
+    void sendAck(uint16_t sequence);
+    void stampAcks(Protocol::PacketHeader& header);
+    void handlePacket(const uint8_t* data, size_t size, clock::time_point now);
+    uint8_t scriptedInput(clock::time_point now) const;
+
+    uint32_t _index;
+    uint32_t _roomId;
+    sockaddr_in _server;
+    bool _compression;
+    int _fd;
+
+    State _state;
+    uint32_t _clientId;
+    uint16_t _sequence;
+
+    clock::time_point _start;
+    clock::time_point _lastConnectAttempt;
+    clock::time_point _nextInput;
+    clock::time_point _nextPing;
+    clock::time_point _lastSnapshot;
+    uint32_t _snapshotTick;
+    bool _hasSnapshot;
+
+    std::unordered_map<uint16_t, clock::time_point> _pendingPings;
+    Network::SequenceWindow _receivedReliable;
+    Network::Reassembler _reassembler;
+    Network::ReliableUDP _ordered;
+    Network::AckWindow _acks;
+    bool _ackPending;
+    clock::time_point _ackDue;
+    ClientStats _stats;
+
+    static constexpr auto INPUT_INTERVAL = std::chrono::microseconds(16667);
+    static constexpr auto PING_INTERVAL = std::chrono::seconds(1);
+    static constexpr auto CONNECT_RETRY = std::chrono::seconds(1);
+    static constexpr size_t MAX_PENDING_PINGS = 16;
+};
+
+} // namespace RType::LoadGen
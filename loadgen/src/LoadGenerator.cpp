@@ -0,0 +1,241 @@
+#include "LoadGenerator.hpp"
+#include <arpa/inet.h>
+#include <poll.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <thread>
+
+namespace RType::LoadGen {
+
+namespace {
+    double percentile(std::vector<double>& values, double p)
+    {
+        if (values.empty()) {
+            return 0.0;
+        }
+        size_t rank = static_cast<size_t>(p * static_cast<double>(values.size() - 1));
+        std::nth_element(values.begin(), values.begin() + rank, values.end());
+        return values[rank];
+    }
+
+    double mean(const std::vector<double>& values)
+    {
+        if (values.empty()) {
+            return 0.0;
+        }
+        return std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+    }
+
+    double stddev(const std::vector<double>& values, double avg)
+    {
+        if (values.size() < 2) {
+            return 0.0;
+        }
+        double sum = 0.0;
+        for (double v : values) {
+            sum += (v - avg) * (v - avg);
+        }
+        return std::sqrt(sum / static_cast<double>(values.size() - 1));
+    }
+
+    // The initializer of SNAPSHOT_BYTE_FREQUENCIES, scaled down to fit
+    // 32 bits; only the ratios matter to the codec.
+    bool writeFrequencies(const std::string& path, const std::array<uint64_t, 256>& counts)
+    {
+        std::ofstream out(path);
+        if (!out) {
+            return false;
+        }
+        uint64_t max = *std::max_element(counts.begin(), counts.end());
+        uint64_t divisor = max / UINT32_MAX + 1;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            out << (i % 16 == 0 ? "    " : " ") << counts[i] / divisor << ",";
+            if (i % 16 == 15) {
+                out << "\n";
+            }
+        }
+        return static_cast<bool>(out);
+    }
+}
+
+LoadGenerator::LoadGenerator(LoadConfig config)
+    : _config(std::move(config))
+    , _stopRequested(false)
+{
+}
+
+int LoadGenerator::run()
+{
+    sockaddr_in server{};
+    server.sin_family = AF_INET;
+    server.sin_port = htons(_config.port);
+    if (inet_pton(AF_INET, _config.host.c_str(), &server.sin_addr) <= 0) {
+        std::cerr << "[LoadGen] Invalid server address " << _config.host << std::endl;
+        return 1;
+    }
+
+    uint32_t threads = std::max(1u, std::min(_config.threads, _config.clients));
+    uint32_t perRoom = std::max(1u, _config.players_per_room);
+
+    std::vector<std::vector<std::unique_ptr<SimulatedClient>>> shards(threads);
+    for (uint32_t i = 0; i < _config.clients; ++i) {
+        uint32_t room = _config.room_base + i / perRoom;
+        shards[i % threads].push_back(std::make_unique<SimulatedClient>(i, room, server, _config.compression));
+    }
+
+    std::cout << "[LoadGen] " << _config.clients << " clients in "
+              << (_config.clients + perRoom - 1) / perRoom << " rooms against "
+              << _config.host << ":" << _config.port << " for "
+              << _config.duration.count() << "s on " << threads << " threads" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (uint32_t t = 0; t < threads; ++t) {
+        workers.emplace_back(&LoadGenerator::workerLoop, this, t, std::ref(shards[t]));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    report(shards, std::chrono::steady_clock::now() - start);
+    return 0;
+}
+
+void LoadGenerator::workerLoop(size_t index, std::vector<std::unique_ptr<SimulatedClient>>& clients)
+{
+    using clock = std::chrono::steady_clock;
+
+    auto start = clock::now();
+    auto end = start + _config.duration;
+    size_t opened = 0;
+    std::vector<pollfd> fds;
+    fds.reserve(clients.size());
+
+    while (!_stopRequested) {
+        auto now = clock::now();
+        if (now >= end) {
+            break;
+        }
+
+        // Spread connects over the ramp-up window so the server sees a
+        // realistic join rate rather than a single burst.
+        while (opened < clients.size()) {
+            auto due = start + _config.ramp_up * opened / clients.size();
+            if (now < due) {
+                break;
+            }
+            if (!clients[opened]->open()) {
+                std::cerr << "[LoadGen] Worker " << index << " failed to open socket" << std::endl;
+                _stopRequested = true;
+                break;
+            }
+            fds.push_back({clients[opened]->getFd(), POLLIN, 0});
+            ++opened;
+        }
+
+        for (size_t i = 0; i < opened; ++i) {
+            clients[i]->update(now);
+        }
+
+        int ready = ::poll(fds.data(), fds.size(), 1);
+        if (ready <= 0) {
+            continue;
+        }
+
+        now = clock::now();
+        for (size_t i = 0; i < fds.size(); ++i) {
+            if (fds[i].revents & POLLIN) {
+                clients[i]->drain(now);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < opened; ++i) {
+        clients[i]->disconnect();
+    }
+}
+
+void LoadGenerator::report(const std::vector<std::vector<std::unique_ptr<SimulatedClient>>>& shards,
+                           std::chrono::duration<double> elapsed) const
+{
+    uint64_t playing = 0;
+    uint64_t rejected = 0;
+    uint64_t packets = 0;
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+    uint64_t snapshots = 0;
+    uint64_t inputs = 0;
+    uint64_t retries = 0;
+    uint64_t snapshotWire = 0;
+    uint64_t snapshotBody = 0;
+    std::array<uint64_t, 256> byteCounts{};
+    std::vector<double> interArrival;
+    std::vector<double> rtt;
+
+    for (const auto& shard : shards) {
+        for (const auto& client : shard) {
+            const auto& stats = client->getStats();
+            if (client->getState() == SimulatedClient::State::PLAYING) {
+                ++playing;
+            } else if (client->getState() == SimulatedClient::State::REJECTED) {
+                ++rejected;
+            }
+            packets += stats.packets_received;
+            bytesIn += stats.bytes_received;
+            bytesOut += stats.bytes_sent;
+            snapshots += stats.snapshots;
+            inputs += stats.inputs_sent;
+            retries += stats.connect_retries;
+            snapshotWire += stats.snapshot_wire_bytes;
+            snapshotBody += stats.snapshot_body_bytes;
+            for (size_t b = 0; b < byteCounts.size(); ++b) {
+                byteCounts[b] += stats.snapshot_byte_counts[b];
+            }
+            interArrival.insert(interArrival.end(), stats.inter_arrival_ms.begin(), stats.inter_arrival_ms.end());
+            rtt.insert(rtt.end(), stats.rtt_ms.begin(), stats.rtt_ms.end());
+        }
+    }
+
+    double seconds = std::max(elapsed.count(), 1e-3);
+    double clients = std::max<double>(1.0, static_cast<double>(_config.clients));
+    double iaMean = mean(interArrival);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n===== r-type_loadgen report (" << seconds << "s) =====" << std::endl;
+    std::cout << "clients playing      : " << playing << "/" << _config.clients
+              << " (rejected " << rejected << ", connect retries " << retries << ")" << std::endl;
+    std::cout << "inputs sent          : " << inputs << " (" << inputs / seconds / clients << " Hz/client)" << std::endl;
+    std::cout << "packets received     : " << packets << " (" << packets / seconds << " pkt/s)" << std::endl;
+    std::cout << "bytes in / out       : " << bytesIn / seconds / 1024.0 << " / "
+              << bytesOut / seconds / 1024.0 << " KiB/s" << std::endl;
+    std::cout << "bytes in per client  : " << bytesIn / seconds / clients << " B/s" << std::endl;
+    std::cout << "snapshot rate        : " << snapshots / seconds / clients << " Hz/client" << std::endl;
+    std::cout << "snapshot bodies      : " << snapshotWire / seconds / clients << " B/s/client on the wire, "
+              << snapshotBody / seconds / clients << " decoded ("
+              << (snapshotBody > 0 ? 100.0 * (1.0 - static_cast<double>(snapshotWire) / static_cast<double>(snapshotBody)) : 0.0)
+              << "% saved)" << std::endl;
+    std::cout << "inter-arrival (ms)   : mean " << iaMean
+              << " jitter(sd) " << stddev(interArrival, iaMean)
+              << " p50 " << percentile(interArrival, 0.50)
+              << " p99 " << percentile(interArrival, 0.99)
+              << " max " << percentile(interArrival, 1.0) << std::endl;
+    std::cout << "rtt (ms)             : samples " << rtt.size()
+              << " p50 " << percentile(rtt, 0.50)
+              << " p90 " << percentile(rtt, 0.90)
+              << " p99 " << percentile(rtt, 0.99)
+              << " max " << percentile(rtt, 1.0) << std::endl;
+
+    if (!_config.train_output.empty()) {
+        if (writeFrequencies(_config.train_output, byteCounts)) {
+            std::cout << "[LoadGen] Snapshot byte frequencies written to " << _config.train_output << std::endl;
+        } else {
+            std::cerr << "[LoadGen] Cannot write " << _config.train_output << std::endl;
+        }
+    }
+}
+
+} // namespace RType::LoadGen
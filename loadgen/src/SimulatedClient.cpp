@@ -0,0 +1,400 @@
+#include "SimulatedClient.hpp"
+#include "network/BitStream.hpp"
+#include "network/SnapshotCodec.hpp"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <array>
+#include <cstring>
+
+namespace RType::LoadGen {
+
+SimulatedClient::SimulatedClient(uint32_t index, uint32_t room_id, const sockaddr_in& server, bool compression)
+    : _index(index)
+    , _roomId(room_id)
+    , _server(server)
+    , _compression(compression)
+    , _fd(-1)
+    , _state(State::CONNECTING)
+    , _clientId(0)
+    , _sequence(1)
+    , _start(clock::now())
+    , _snapshotTick(0)
+    , _hasSnapshot(false)
+    , _ackPending(false)
+{
+}
+
+SimulatedClient::~SimulatedClient()
+{
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+}
+
+bool SimulatedClient::open()
+{
+    _fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (_fd < 0) {
+        return false;
+    }
+
+    int flags = fcntl(_fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(_fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        ::close(_fd);
+        _fd = -1;
+        return false;
+    }
+
+    int rcvbuf = 256 * 1024;
+    setsockopt(_fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    sendConnect();
+    return true;
+}
+
+void SimulatedClient::stampAcks(Protocol::PacketHeader& header)
+{
+    if (_acks.valid) {
+        header.setAcks(_acks.ack, _acks.bits);
+        _ackPending = false;
+    }
+}
+
+void SimulatedClient::send(const void* data, size_t size)
+{
+    ssize_t sent = ::sendto(_fd, data, size, 0,
+                            reinterpret_cast<const sockaddr*>(&_server), sizeof(_server));
+    if (sent > 0) {
+        _stats.bytes_sent += static_cast<uint64_t>(sent);
+    }
+}
+
+void SimulatedClient::sendConnect()
+{
+    Protocol::ConnectRequest request;
+    request.header.sequence_number = _sequence++;
+    request.room_id = _roomId;
+    if (_compression) {
+        request.capabilities = Protocol::CAPABILITY_SNAPSHOT_COMPRESSION;
+    }
+    std::strncpy(request.client_version, "1.0.0", sizeof(request.client_version) - 1);
+    std::string name = "bot" + std::to_string(_index);
+    std::strncpy(request.player_name, name.c_str(), sizeof(request.player_name) - 1);
+
+    send(&request, sizeof(request));
+    _lastConnectAttempt = clock::now();
+}
+
+uint8_t SimulatedClient::scriptedInput(clock::time_point now) const
+{
+    // Sweep the four directions every two seconds and tap fire twice a
+    // second, offset per client so a room does not move in lockstep.
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - _start).count()
+                   + static_cast<long long>(_index) * 137;
+    static constexpr uint8_t DIRECTIONS[] = {0x01, 0x08, 0x02, 0x04};
+
+    uint8_t flags = DIRECTIONS[(elapsed / 500) % 4];
+    if (elapsed % 500 < 300) {
+        flags |= 0x10;
+    }
+    return flags;
+}
+
+void SimulatedClient::sendInput(clock::time_point now)
+{
+    Protocol::PlayerInput input;
+    input.header.sequence_number = _sequence++;
+    input.client_id = _clientId;
+    input.input_flags = scriptedInput(now);
+    input.timestamp = static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(now - _start).count());
+    stampAcks(input.header);
+
+    send(&input, sizeof(input));
+    _stats.inputs_sent++;
+}
+
+void SimulatedClient::sendPing(clock::time_point now)
+{
+    Protocol::PacketHeader ping;
+    ping.type = Protocol::PacketType::PING;
+    ping.sequence_number = _sequence++;
+
+    if (_pendingPings.size() >= MAX_PENDING_PINGS) {
+        _pendingPings.clear();
+    }
+    _pendingPings[ping.sequence_number] = now;
+    stampAcks(ping);
+    send(&ping, sizeof(ping));
+}
+
+void SimulatedClient::sendAck(uint16_t sequence)
+{
+    Protocol::AckPacket ack;
+    ack.ack_sequence = sequence;
+    stampAcks(ack.header);
+    send(&ack, sizeof(ack));
+}
+
+void SimulatedClient::update(clock::time_point now)
+{
+    switch (_state) {
+        case State::CONNECTING:
+            if (now - _lastConnectAttempt >= CONNECT_RETRY) {
+                _stats.connect_retries++;
+                sendConnect();
+            }
+            return;
+
+        case State::REJECTED:
+            return;
+
+        case State::LOBBY:
+        case State::PLAYING:
+            break;
+    }
+
+    if (now >= _nextPing) {
+        sendPing(now);
+        _nextPing = now + PING_INTERVAL;
+    }
+
+    if (_state == State::PLAYING && now >= _nextInput) {
+        sendInput(now);
+        _nextInput += INPUT_INTERVAL;
+        if (_nextInput < now) {
+            _nextInput = now + INPUT_INTERVAL;
+        }
+    }
+
+    // Nothing carried the acks in time: send them on their own.
+    if (_ackPending && now >= _ackDue) {
+        sendAck(_acks.ack);
+    }
+
+    _ordered.poll(now, [&](const uint8_t* message, size_t length) { handlePacket(message, length, now); });
+}
+
+void SimulatedClient::drain(clock::time_point now)
+{
+    std::array<uint8_t, 4096> buffer{};
+
+    while (true) {
+        ssize_t received = ::recv(_fd, buffer.data(), buffer.size(), 0);
+        if (received <= 0) {
+            return;
+        }
+
+        _stats.packets_received++;
+        _stats.bytes_received += static_cast<uint64_t>(received);
+        handlePacket(buffer.data(), static_cast<size_t>(received), now);
+    }
+}
+
+void SimulatedClient::handlePacket(const uint8_t* data, size_t size, clock::time_point now)
+{
+    if (size < sizeof(Protocol::PacketHeader)) {
+        return;
+    }
+
+    Protocol::PacketHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (!Protocol::IsValidPacket(header)) {
+        return;
+    }
+
+    if (header.isReliable()) {
+        if (!_acks.record(header.sequence_number)) {
+            sendAck(header.sequence_number);
+        } else if (!_ackPending) {
+            _ackPending = true;
+            _ackDue = now + Network::AckWindow::FLUSH_DELAY;
+        }
+        if (_receivedReliable.contains(header.sequence_number)) {
+            return;
+        }
+        _receivedReliable.insert(header.sequence_number);
+    }
+
+    if (header.type == Protocol::PacketType::FRAGMENT) {
+        if (size < sizeof(Protocol::FragmentHeader)) {
+            return;
+        }
+        Protocol::FragmentHeader fragmentHeader;
+        std::memcpy(&fragmentHeader, data, sizeof(fragmentHeader));
+        Network::Reassembler::Fragment fragment{fragmentHeader.message_id, fragmentHeader.fragment_index,
+                                                fragmentHeader.fragment_count, fragmentHeader.total_size,
+                                                fragmentHeader.offset, data + sizeof(fragmentHeader),
+                                                size - sizeof(fragmentHeader)};
+        if (const auto* message = _reassembler.add(Network::Endpoint(), fragment, now)) {
+            std::vector<uint8_t> whole(*message);
+            handlePacket(whole.data(), whole.size(), now);
+        }
+        return;
+    }
+
+    if (header.type == Protocol::PacketType::ORDERED) {
+        if (size < sizeof(Protocol::OrderedHeader)) {
+            return;
+        }
+        Protocol::OrderedHeader ordered;
+        std::memcpy(&ordered, data, sizeof(ordered));
+        _ordered.receive(ordered.order_sequence, data + sizeof(ordered), size - sizeof(ordered), now,
+                         [&](const uint8_t* message, size_t length) { handlePacket(message, length, now); });
+        return;
+    }
+
+    if (header.type == Protocol::PacketType::BUNDLE) {
+        if (size < sizeof(Protocol::BundleHeader)) {
+            return;
+        }
+        Protocol::BundleHeader bundle;
+        std::memcpy(&bundle, data, sizeof(bundle));
+        size_t offset = sizeof(bundle);
+        for (uint8_t i = 0; i < bundle.message_count; ++i) {
+            uint16_t length = 0;
+            if (size - offset < sizeof(length)) {
+                break;
+            }
+            std::memcpy(&length, data + offset, sizeof(length));
+            offset += sizeof(length);
+            if (length > size - offset) {
+                break;
+            }
+            handlePacket(data + offset, length, now);
+            offset += length;
+        }
+        return;
+    }
+
+    switch (header.type) {
+        case Protocol::PacketType::CONNECT_RESPONSE: {
+            if (_state != State::CONNECTING || size < sizeof(Protocol::ConnectResponse)) {
+                break;
+            }
+            Protocol::ConnectResponse response;
+            std::memcpy(&response, data, sizeof(response));
+
+            if (response.status != Protocol::ConnectionStatus::ACCEPTED) {
+                _state = State::REJECTED;
+                break;
+            }
+
+            _clientId = response.client_id;
+            _state = State::LOBBY;
+            _nextPing = now;
+
+            Protocol::ReadyToPlay ready;
+            ready.header.sequence_number = _sequence++;
+            ready.client_id = _clientId;
+            ready.ready = 1;
+            stampAcks(ready.header);
+            send(&ready, sizeof(ready));
+            break;
+        }
+
+        case Protocol::PacketType::GAME_ON:
+            if (_state == State::LOBBY) {
+                _state = State::PLAYING;
+                _nextInput = now;
+            }
+            break;
+
+        case Protocol::PacketType::LOBBY_STATUS: {
+            // Late joiners never see GAME_ON; the lobby status tells them
+            // the room is already playing.
+            if (_state != State::LOBBY || size < sizeof(Protocol::LobbyStatus)) {
+                break;
+            }
+            Protocol::LobbyStatus status;
+            std::memcpy(&status, data, sizeof(status));
+            if (status.game_started != 0) {
+                _state = State::PLAYING;
+                _nextInput = now;
+            }
+            break;
+        }
+
+        case Protocol::PacketType::ENTITY_UPDATE: {
+            Network::EncodedPacket<sizeof(Protocol::BatchedEntityUpdate)> inflated;
+            const uint8_t* snapshot = data;
+            size_t snapshotSize = size;
+            if (header.isCompressed()) {
+                if (!Network::decompressBody(data, size, sizeof(header), inflated)) {
+                    break;
+                }
+                snapshot = inflated.bytes;
+                snapshotSize = inflated.size;
+            }
+            Protocol::BatchedEntityUpdate batch;
+            if (!Network::decode(snapshot, snapshotSize, batch)) {
+                break;
+            }
+            uint32_t tick = batch.tick;
+            // Late snapshots are neither counted nor acked, like the game
+            // client drops them.
+            if (_hasSnapshot && static_cast<int32_t>(tick - _snapshotTick) <= 0) {
+                break;
+            }
+            if (_hasSnapshot) {
+                _stats.inter_arrival_ms.push_back(
+                    std::chrono::duration<double, std::milli>(now - _lastSnapshot).count());
+            }
+            _stats.snapshots++;
+            _stats.snapshot_wire_bytes += size - sizeof(header);
+            _stats.snapshot_body_bytes += snapshotSize - sizeof(header);
+            for (size_t i = sizeof(header); i < snapshotSize; ++i) {
+                _stats.snapshot_byte_counts[snapshot[i]]++;
+            }
+            _hasSnapshot = true;
+            _snapshotTick = tick;
+            _lastSnapshot = now;
+
+            // Without acks the server would resend every entity each tick.
+            Protocol::SnapshotAck ack;
+            ack.header.sequence_number = _sequence++;
+            ack.tick = tick;
+            stampAcks(ack.header);
+            send(&ack, ack.getPacketSize());
+            break;
+        }
+
+        case Protocol::PacketType::PONG: {
+            auto it = _pendingPings.find(header.sequence_number);
+            if (it != _pendingPings.end()) {
+                _stats.rtt_ms.push_back(
+                    std::chrono::duration<double, std::milli>(now - it->second).count());
+                _pendingPings.erase(it);
+            }
+            break;
+        }
+
+        case Protocol::PacketType::PING: {
+            Protocol::PacketHeader pong;
+            pong.type = Protocol::PacketType::PONG;
+            pong.sequence_number = header.sequence_number;
+            stampAcks(pong);
+            send(&pong, sizeof(pong));
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+void SimulatedClient::disconnect()
+{
+    if (_fd < 0 || _state == State::CONNECTING || _state == State::REJECTED) {
+        return;
+    }
+
+    Protocol::DisconnectPacket packet;
+    packet.header.sequence_number = _sequence++;
+    packet.client_id = _clientId;
+    stampAcks(packet.header);
+    send(&packet, sizeof(packet));
+}
+
+} // namespace RType::LoadGen
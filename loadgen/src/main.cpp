@@ -0,0 +1,84 @@
+#include "LoadGenerator.hpp"
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    RType::LoadGen::LoadGenerator* g_generator = nullptr;
+
+    void signalHandler(int)
+    {
+        if (g_generator) {
+            g_generator->requestStop();
+        }
+    }
+
+    void usage(const char* name)
+    {
+        std::cout << "Usage: " << name << " [options]\n"
+                  << "  --host <ip>          server address (default 127.0.0.1)\n"
+                  << "  --port <port>        server port (default 4242)\n"
+                  << "  --clients <n>        simulated clients (default 200)\n"
+                  << "  --threads <n>        generator threads (default 4)\n"
+                  << "  --per-room <n>       players per room (default 4)\n"
+                  << "  --room-base <id>     first room id (default 1000)\n"
+                  << "  --duration <sec>     run time (default 30)\n"
+                  << "  --ramp-up <ms>       connect spread (default 2000)\n"
+                  << "  --compression <on|off> offer snapshot compression (default on)\n"
+                  << "  --train <file>       write snapshot byte frequencies for SnapshotCodec.hpp" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    RType::LoadGen::LoadConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            usage(argv[0]);
+            return 0;
+        }
+        if (!value) {
+            usage(argv[0]);
+            return 1;
+        }
+
+        if (std::strcmp(arg, "--host") == 0) {
+            config.host = value;
+        } else if (std::strcmp(arg, "--port") == 0) {
+            config.port = static_cast<uint16_t>(std::atoi(value));
+        } else if (std::strcmp(arg, "--clients") == 0) {
+            config.clients = static_cast<uint32_t>(std::atoi(value));
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            config.threads = static_cast<uint32_t>(std::atoi(value));
+        } else if (std::strcmp(arg, "--per-room") == 0) {
+            config.players_per_room = static_cast<uint32_t>(std::atoi(value));
+        } else if (std::strcmp(arg, "--room-base") == 0) {
+            config.room_base = static_cast<uint32_t>(std::atoi(value));
+        } else if (std::strcmp(arg, "--duration") == 0) {
+            config.duration = std::chrono::seconds(std::atoi(value));
+        } else if (std::strcmp(arg, "--ramp-up") == 0) {
+            config.ramp_up = std::chrono::milliseconds(std::atoi(value));
+        } else if (std::strcmp(arg, "--compression") == 0) {
+            config.compression = std::strcmp(value, "off") != 0;
+        } else if (std::strcmp(arg, "--train") == 0) {
+            config.train_output = value;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+        ++i;
+    }
+
+    RType::LoadGen::LoadGenerator generator(config);
+    g_generator = &generator;
+
+    signal(SIGINT, signalHandler);
+    signal(SIGTERM, signalHandler);
+
+    return generator.run();
+}
@@ -1,6 +1,7 @@
 #pragma once
 
-#include "network/ISocket.hpp"
+#include "network/Endpoint.hpp"
+#include "network/ReliableChannel.hpp"
 #include <chrono>
 #include <string>
 #include <memory>
@@ -15,23 +16,23 @@ enum class ClientState {
 
 class Client {
 public:
-    Client(uint32_t id, std::shared_ptr<Network::IAddress> addr, const std::string& name)
-        : _id(id), _address(std::move(addr)), _name(name),
+    Client(uint32_t id, const Network::Endpoint& addr, const std::string& name,
+           uint32_t room_id = 0)
+        : _id(id), _address(addr), _name(name),
           _state(ClientState::CONNECTING),
-          _player_slot(0), _sequence_number(0) {
+          _room_id(room_id), _player_slot(0) {
         updateLastActivity();
     }
     
     uint32_t getId() const { return _id; }
-    const std::shared_ptr<Network::IAddress>& getAddress() const { return _address; }
+    const Network::Endpoint& getAddress() const { return _address; }
     const std::string& getName() const { return _name; }
     ClientState getState() const { return _state; }
+    uint32_t getRoomId() const { return _room_id; }
     uint8_t getPlayerSlot() const { return _player_slot; }
-    uint32_t getSequenceNumber() const { return _sequence_number; }
     
     void setState(ClientState state) { _state = state; }
     void setPlayerSlot(uint8_t slot) { _player_slot = slot; }
-    void incrementSequence() { _sequence_number++; }
     
     void updateLastActivity() {
         _last_activity = std::chrono::steady_clock::now();
@@ -45,13 +46,17 @@ public:
     
     auto getLastActivity() const { return _last_activity; }
 
+    // Guarded by the NetworkModule that owns this client.
+    Network::ReliableChannel& reliableChannel() { return _reliable; }
+
 private:
     uint32_t _id;
-    std::shared_ptr<Network::IAddress> _address;
+    Network::Endpoint _address;
     std::string _name;
     ClientState _state;
+    uint32_t _room_id;
     uint8_t _player_slot;
-    uint32_t _sequence_number;
+    Network::ReliableChannel _reliable;
     std::chrono::steady_clock::time_point _last_activity;
 };
 
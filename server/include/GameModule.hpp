@@ -3,11 +3,10 @@
 #include "engine/systems/MovementSystem.hpp"
 #include "levels/LevelManager.hpp"
 #include "protocol/Protocol.hpp"
+#include "core/FrameSlot.hpp"
 #include <memory>
-#include <mutex>
 #include <queue>
 #include <random>
-#include <shared_mutex>
 #include <unordered_map>
 
 enum class EventType {
@@ -39,6 +38,13 @@ struct EntitySnapshot {
   uint8_t player_slot;
 };
 
+// Immutable view of the world published after a snapshot is taken. Safe to
+// read from any thread once obtained from GameModule::latestFrame().
+struct WorldFrame {
+  uint64_t tick;
+  std::vector<EntitySnapshot> entities;
+};
+
 struct PlayerState {
   bool isCharging = false;
   float chargeTime = 0.f;
@@ -48,6 +54,9 @@ struct PlayerState {
   bool doubleFireRate = false;
 };
 
+// Owned by a single thread (the room worker): every method except
+// latestFrame() must be called from that thread, so none of them lock.
+// Other threads receive world state through published WorldFrames.
 class GameModule {
 private:
   static constexpr size_t MAX_PLAYERS = 4;
@@ -70,11 +79,6 @@ private:
   std::unique_ptr<MovementSystem> _movementSystem;
   std::unique_ptr<LevelManager> _levelManager;
 
-  mutable std::shared_mutex _registryMutex;
-  mutable std::mutex _playerMutex;
-  mutable std::mutex _eventMutex;
-  mutable std::mutex _scoreMutex;
-
   std::unordered_map<uint32_t, EntityID> _playerEntities;
   std::unordered_map<uint32_t, PlayerState> _playerStates;
   std::queue<LocalGameEvent> _eventQueue;
@@ -99,6 +103,9 @@ private:
 
   bool _gameOverFlag;
 
+  uint64_t _tick;
+  RType::Core::FrameSlot<WorldFrame> _frame;
+
 public:
   GameModule();
 
@@ -106,6 +113,11 @@ public:
   void update(float dt);
 
   std::vector<EntitySnapshot> getWorldSnapshot();
+
+  // Captures the current world into a new frame and publishes it.
+  std::shared_ptr<const WorldFrame> publishFrame();
+  std::shared_ptr<const WorldFrame> latestFrame() const { return _frame.load(); }
+
   std::vector<LocalGameEvent> pollEvents();
   std::vector<RType::Protocol::GameEvent> pollNetworkEvents();
 
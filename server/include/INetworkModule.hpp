@@ -1,11 +1,16 @@
 #pragma once
 
+#include "network/Endpoint.hpp"
+#include "network/PacketPool.hpp"
 #include <vector>
 #include <memory>
 #include <cstdint>
 #include <chrono>
+#include <algorithm>
+#include <thread>
 #include <string>
 #include <type_traits>
+#include <utility>
 
 namespace RType {
 namespace Server {
@@ -15,84 +20,170 @@ namespace Server {
 
 namespace RType::Network {
 
-class IAddress;
-
 struct ReceivedMessage {
     uint32_t client_id;
-    std::shared_ptr<IAddress> source_addr;
+    Endpoint source_addr;
     uint8_t packet_type;
-    std::vector<uint8_t> payload;
+    PacketBuffer payload;
     size_t payload_size;
 };
 
+// What registerClient() found. Rooms register from their own worker
+// threads, so an address may have been claimed by another room since it
+// was looked up; only the room that created the entry may keep it.
+struct ClientRegistration {
+    uint32_t client_id = 0;
+    bool created = false;
+    uint32_t room_id = 0;   // the room the address is registered to
+};
+
+template<typename T, typename = void>
+struct HasPacketSize : std::false_type {};
+
+template<typename T>
+struct HasPacketSize<T, std::void_t<decltype(std::declval<const T&>().getPacketSize())>>
+    : std::true_type {};
+
+// Bytes of packet that go on the wire. Packets with a variable-length tail
+// (a count followed by a fixed-capacity array) report their used size via
+// getPacketSize(); everything else is sent whole.
+template<typename T>
+size_t wireSize(const T& packet)
+{
+    if constexpr (HasPacketSize<T>::value)
+        return packet.getPacketSize();
+    else
+        return sizeof(T);
+}
+
 class INetworkModule {
 public:
+    static constexpr size_t DEFAULT_MTU = 1200;
+
     virtual ~INetworkModule() = default;
 
     virtual bool start(uint16_t port) = 0;
     virtual void stop() = 0;
     virtual bool isRunning() const = 0;
 
-    virtual std::vector<ReceivedMessage> pollMessages() = 0;
+    // Replaces the contents of out with every message received since the
+    // last call. Reusing the same vector keeps polling allocation-free.
+    virtual void pollMessages(std::vector<ReceivedMessage>& out) = 0;
+
+    // Blocks until pollMessages() may have something to return, deadline
+    // passes, or wakeWaiter() is called. Modules that cannot signal
+    // arrivals sleep for at most a millisecond instead.
+    virtual void waitForMessages(std::chrono::steady_clock::time_point deadline) {
+        auto nap = std::chrono::steady_clock::now() + std::chrono::milliseconds(1);
+        std::this_thread::sleep_until(std::min(deadline, nap));
+    }
+
+    virtual void wakeWaiter() {}
 
     template<typename T>
     void sendToClient(uint32_t client_id, const T& packet) {
         static_assert(std::is_trivially_copyable_v<T>, 
                      "Packet must be trivially copyable");
-        sendToClientRaw(client_id, &packet, sizeof(T));
+        sendToClientRaw(client_id, &packet, wireSize(packet));
+    }
+
+    // Sends packet on the client's ordered channel: reliably, and handed to
+    // the client's game code only after every ordered message sent before
+    // it.
+    template<typename T>
+    void sendOrdered(uint32_t client_id, const T& packet) {
+        static_assert(std::is_trivially_copyable_v<T>,
+                     "Packet must be trivially copyable");
+        sendOrderedRaw(client_id, &packet, wireSize(packet));
     }
 
     template<typename T>
     void broadcast(const T& packet) {
         static_assert(std::is_trivially_copyable_v<T>,
                      "Packet must be trivially copyable");
-        broadcastRaw(&packet, sizeof(T), 0);
+        broadcastRaw(&packet, wireSize(packet), 0);
     }
 
     template<typename T>
     void broadcastExcept(uint32_t exclude_id, const T& packet) {
         static_assert(std::is_trivially_copyable_v<T>,
                      "Packet must be trivially copyable");
-        broadcastRaw(&packet, sizeof(T), exclude_id);
+        broadcastRaw(&packet, wireSize(packet), exclude_id);
     }
 
     template<typename T>
-    void sendToAddress(const std::shared_ptr<IAddress>& addr, const T& packet) {
+    void sendToAddress(const Endpoint& addr, const T& packet) {
         static_assert(std::is_trivially_copyable_v<T>,
                      "Packet must be trivially copyable");
-        sendToAddressRaw(addr, &packet, sizeof(T));
+        sendToAddressRaw(addr, &packet, wireSize(packet));
     }
 
     virtual std::vector<uint32_t> getConnectedClients() const = 0;
     virtual size_t getClientCount() const = 0;
     virtual void disconnectClient(uint32_t client_id) = 0;
 
-    virtual bool hasAvailableSlot() const = 0;
-    virtual uint8_t findFreePlayerSlot() const = 0;
-
-    virtual uint32_t registerClient(const std::shared_ptr<IAddress>& addr, 
-                                    const std::string& name, 
-                                    uint8_t slot) = 0;
+    // Registers addr for room_id unless it is already registered, in
+    // which case the existing entry is reported and left untouched.
+    virtual ClientRegistration registerClient(const Endpoint& addr,
+                                              const std::string& name,
+                                              uint32_t room_id,
+                                              uint8_t slot) = 0;
 
     virtual void unregisterClient(uint32_t client_id) = 0;
 
     virtual std::vector<uint32_t> checkTimeouts(std::chrono::seconds timeout) = 0;
     
     virtual std::shared_ptr<RType::Server::Client> getClient(uint32_t client_id) const = 0;
-    virtual std::shared_ptr<RType::Server::Client> getClientByAddress(const std::shared_ptr<IAddress>& addr) const = 0;
+    virtual std::shared_ptr<RType::Server::Client> getClientByAddress(const Endpoint& addr) const = 0;
+
+    // Packets sent from the calling thread between beginBatch() and flush()
+    // may be queued and handed to the socket together. Modules that send
+    // immediately can ignore both.
+    virtual void beginBatch() {}
+    virtual void flush() {}
+
+    // Sends a round-trip probe to every connected client. Modules that do
+    // not estimate RTT can ignore it.
+    virtual void pingClients() {}
+
+    // The largest datagram the module sends without fragmenting it.
+    virtual size_t getMtu() const { return DEFAULT_MTU; }
 
 protected:
     virtual void sendToClientRaw(uint32_t client_id, 
                                 const void* data, 
                                 size_t size) = 0;
 
-    virtual void sendToAddressRaw(const std::shared_ptr<IAddress>& addr,
+    virtual void sendToAddressRaw(const Endpoint& addr,
                                  const void* data, 
                                  size_t size) = 0;
 
     virtual void broadcastRaw(const void* data, 
                             size_t size, 
                             uint32_t exclude_id) = 0;
+
+    // Modules without an ordered channel send the packet as it is.
+    virtual void sendOrderedRaw(uint32_t client_id, const void* data, size_t size) {
+        sendToClientRaw(client_id, data, size);
+    }
+};
+
+// Batches every packet the current thread sends during its lifetime.
+class SendBatch {
+public:
+    explicit SendBatch(INetworkModule& network)
+        : _network(network)
+    {
+        _network.beginBatch();
+    }
+
+    ~SendBatch() { _network.flush(); }
+
+    SendBatch(const SendBatch&) = delete;
+    SendBatch& operator=(const SendBatch&) = delete;
+
+private:
+    INetworkModule& _network;
 };
 
 } // namespace RType::Network
\ No newline at end of file
@@ -2,110 +2,174 @@
 
 #include "INetworkModule.hpp"
 #include "network/ISocket.hpp"
-#include "network/UDPAddress.hpp"
+#include "network/PacketPool.hpp"
+#include "network/Reassembler.hpp"
+#include "network/ReliableChannel.hpp"
+#include "network/SocketWaiter.hpp"
 #include "Client.hpp"
+#include "core/TimerWheel.hpp"
 #include "protocol/Protocol.hpp"
+#include <array>
 #include <map>
 #include <unordered_map>
-#include <unordered_set>
 #include <memory>
 #include <thread>
 #include <atomic>
 #include <mutex>
-#include <queue>
+#include <condition_variable>
 #include <chrono>
 
 namespace RType::Network {
 
-struct PendingReliablePacket {
-    std::vector<uint8_t> data;
-    std::shared_ptr<IAddress> dest;
-    std::chrono::steady_clock::time_point last_sent;
-    uint16_t sequence;
-    uint8_t retries;
-};
-
 class NetworkModule : public INetworkModule {
 public:
     explicit NetworkModule(std::unique_ptr<ISocket> socket);
+
+    // One receive shard per socket. With more than one, every socket must
+    // allow SO_REUSEPORT so they can all bind the same port; the kernel then
+    // hashes each peer to one shard. The first socket also sends.
+    explicit NetworkModule(std::vector<std::unique_ptr<ISocket>> sockets);
     ~NetworkModule() override;
 
     bool start(uint16_t port) override;
     void stop() override;
     bool isRunning() const override { return _running; }
 
-    std::vector<ReceivedMessage> pollMessages() override;
+    void pollMessages(std::vector<ReceivedMessage>& out) override;
+    void waitForMessages(std::chrono::steady_clock::time_point deadline) override;
+    void wakeWaiter() override;
 
     std::vector<uint32_t> getConnectedClients() const override;
     size_t getClientCount() const override;
     void disconnectClient(uint32_t client_id) override;
 
-    bool hasAvailableSlot() const override;
-    uint8_t findFreePlayerSlot() const override;
-
-    uint32_t registerClient(const std::shared_ptr<IAddress>& addr,
-                           const std::string& name,
-                           uint8_t slot) override;
+    ClientRegistration registerClient(const Endpoint& addr,
+                                      const std::string& name,
+                                      uint32_t room_id,
+                                      uint8_t slot) override;
 
     void unregisterClient(uint32_t client_id) override;
 
     std::vector<uint32_t> checkTimeouts(std::chrono::seconds timeout) override;
 
     std::shared_ptr<Server::Client> getClient(uint32_t client_id) const override;
-    std::shared_ptr<Server::Client> getClientByAddress(const std::shared_ptr<IAddress>& addr) const override;
+    std::shared_ptr<Server::Client> getClientByAddress(const Endpoint& addr) const override;
+
+    void beginBatch() override;
+    void flush() override;
+
+    void pingClients() override;
+
+    // Outgoing packets larger than the MTU are split into fragments that
+    // the peer reassembles, and packets sent to one client within a batch
+    // are packed into bundles up to the MTU. Clamped to
+    // [MIN_MTU, MAX_PACKET_SIZE].
+    void setMtu(size_t mtu);
+    size_t getMtu() const override { return _mtu.load(std::memory_order_relaxed); }
+
+    static constexpr size_t MIN_MTU = 256;
 
 protected:
     void sendToClientRaw(uint32_t client_id, const void* data, size_t size) override;
-    void sendToAddressRaw(const std::shared_ptr<IAddress>& addr, const void* data, size_t size) override;
+    void sendToAddressRaw(const Endpoint& addr, const void* data, size_t size) override;
     void broadcastRaw(const void* data, size_t size, uint32_t exclude_id) override;
+    void sendOrderedRaw(uint32_t client_id, const void* data, size_t size) override;
+
+    size_t getShardCount() const { return _shards.size(); }
 
 private:
-    void receiveLoop();
-    void retryLoop();
-    void processRawPacket(const std::vector<uint8_t>& buffer,
-                         size_t received_size,
-                         const std::shared_ptr<IAddress>& from);
+    // A socket with its own receive thread, buffer pool and message queue,
+    // so shards never contend with each other on the receive path.
+    struct ReceiveShard {
+        ReceiveShard(std::unique_ptr<ISocket> s, size_t poolSlabs)
+            : socket(std::move(s))
+            , pool(poolSlabs, MAX_PACKET_SIZE)
+        {
+        }
+
+        std::unique_ptr<ISocket> socket;
+        std::unique_ptr<SocketWaiter> waiter;
+        std::thread thread;
+        PacketPool pool;
+        Reassembler reassembly;   // receive thread only
+        std::vector<ReceivedMessage> queue;
+        std::mutex queue_mutex;
+    };
+
+    void receiveLoop(ReceiveShard& shard);
+    void signalMessages();
+    void serviceRetransmits();
+    std::chrono::milliseconds retransmitWaitTimeout();
+    bool wakesTimerWait(std::chrono::steady_clock::time_point deadline);
+    void processRawPacket(ReceiveShard& shard, PacketBuffer packet, const Endpoint& from);
+    void reassemble(ReceiveShard& shard, const PacketBuffer& packet, const Endpoint& from);
     bool validatePacket(const Protocol::PacketHeader& header, size_t received_size);
-    void sendRawPacket(const void* data, size_t size, const IAddress& to, bool reliable);
-    void handleAck(uint16_t sequence, const std::shared_ptr<IAddress>& from);
-    void sendAck(uint16_t sequence, const IAddress& dest);
+    void sendRawPacket(const void* data, size_t size, const Endpoint& to,
+                       const std::shared_ptr<Server::Client>& client);
+    void sendFragmented(const void* data, size_t size, const Endpoint& to,
+                        const std::shared_ptr<Server::Client>& client);
+    bool coalesce(const void* data, size_t size, const std::shared_ptr<Server::Client>& client);
+    void closeFrame(size_t index);
+    void deliver(const void* data, size_t size, const Endpoint& to, Server::Client* client);
+    void sendReliable(Server::Client& client, const void* data, size_t size);
+    void handleAcks(Server::Client& client, uint16_t ack, uint32_t ack_bits);
+    bool handlePong(Server::Client& client, uint16_t sequence);
+    void recordRtt(ReliableChannel& channel, std::chrono::steady_clock::duration rtt);
+    bool acceptReliable(Server::Client* client, const Endpoint& from, uint16_t sequence);
+    void sendAck(uint16_t sequence, const Endpoint& dest, Server::Client* client);
+    void flushAck(Server::Client& client);
+    void stampAcks(uint8_t* packet, Server::Client& client);
+    void transmit(const void* data, size_t size, const Endpoint& to, Server::Client* client = nullptr);
+    void sendQueued();
     
     void disconnectClientUnsafe(uint32_t client_id);
 
-    std::unique_ptr<ISocket> _socket;
+    std::vector<std::unique_ptr<ReceiveShard>> _shards;
+    ISocket* _socket;
+
+    // Raised by a shard when its queue stops being empty, and cleared by
+    // waitForMessages() before the caller polls, so no arrival is missed.
+    std::mutex _ready_mutex;
+    std::condition_variable _ready;
+    bool _messages_ready = false;
     uint16_t _port;
 
     std::atomic<bool> _running;
-    std::thread _receive_thread;
-    std::thread _retry_thread;
 
-    std::unordered_map<std::shared_ptr<IAddress>,
-                       std::shared_ptr<Server::Client>,
-                       AddressHash,
-                       AddressEqual> _clients_by_addr;
+    std::unordered_map<Endpoint, std::shared_ptr<Server::Client>, EndpointHash> _clients_by_addr;
 
     std::map<uint32_t, std::shared_ptr<Server::Client>> _clients_by_id;
     mutable std::mutex _clients_mutex;
 
     uint32_t _next_client_id;
 
-    bool _player_slots[4];
-    mutable std::mutex _slots_mutex;
-
-    std::queue<ReceivedMessage> _message_queue;
-    std::mutex _queue_mutex;
-    
-    std::atomic<uint16_t> _next_sequence;
-    std::map<uint16_t, PendingReliablePacket> _pending_reliable;
+    std::atomic<size_t> _mtu;
+    std::atomic<uint16_t> _next_message_id;
+
+    // Reliable packets are tracked per client in its ReliableChannel. Their
+    // retransmit deadlines, and the deadlines for acks still waiting to
+    // ride on outgoing traffic, live in a millisecond timer wheel driven by
+    // the first shard's receive loop. The wheel and every channel's send
+    // side are guarded by _reliable_mutex, taken after _clients_mutex when
+    // both are needed. The loop sleeps until the wheel's next deadline,
+    // recorded in _timer_wait_until; scheduling anything earlier wakes it.
+    Core::TimerWheel _retransmit_timers;
+    std::chrono::steady_clock::time_point _timer_wait_until = std::chrono::steady_clock::time_point::max();
     std::mutex _reliable_mutex;
     
-    std::unordered_map<std::shared_ptr<IAddress>, std::unordered_set<uint16_t>, AddressHash, AddressEqual> _received_sequences;
+    // Receive side (dedup and acks) of known clients' channels. Peers
+    // without a session are not deduplicated. Taken last.
     std::mutex _dedup_mutex;
 
-    static constexpr size_t MAX_PACKET_SIZE = 4096;
-    static constexpr auto RETRY_TIMEOUT = std::chrono::milliseconds(100);
+    // Peers keep their datagrams under the MTU and fragment anything
+    // longer, so receive slabs are MTU-sized and longer datagrams dropped.
+    static constexpr size_t MAX_PACKET_SIZE = 1536;
+    static constexpr size_t RECV_POOL_SLABS = 4096;   // split across shards
+    static constexpr size_t RECV_BATCH = 32;
+    static constexpr size_t SEND_BATCH = 64;
+    static constexpr auto TIMER_RESOLUTION = std::chrono::milliseconds(1);
+    static constexpr size_t TIMER_SLOTS = 1024;
     static constexpr uint8_t MAX_RETRIES = 5;
-    static constexpr size_t MAX_SEQUENCE_HISTORY = 128;
 };
 
 } // namespace RType::Network
\ No newline at end of file
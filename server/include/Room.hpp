@@ -0,0 +1,138 @@
+#pragma once
+
+#include "protocol/Protocol.hpp"
+#include "GameModule.hpp"
+#include "INetworkModule.hpp"
+#include "core/PriorityAccumulator.hpp"
+#include "core/SnapshotBaseline.hpp"
+#include "core/SpscQueue.hpp"
+#include "network/BitStream.hpp"
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace RType::Server {
+
+// One independent match: its own GameModule, lobby and snapshot state.
+// A room is only ever ticked by a single worker thread, which owns the
+// GameModule outright. The dispatcher is the only producer of its inbox,
+// so inputs and acks reach it through an SPSC queue, which drops them when
+// full. Connects and disconnects must never be lost, or a slot would stay
+// taken forever; they go through a small mutex-guarded control list
+// instead, drained first on every tick.
+// getEntityCount() reads the last published WorldFrame and is the only
+// accessor other threads may call besides enqueue().
+class Room {
+public:
+    static constexpr uint8_t MAX_PLAYERS = 4;
+
+    Room(uint32_t id, RType::Network::INetworkModule& network);
+
+    uint32_t getId() const { return _id; }
+
+    // Returns false (and drops the message) when the inbox is full. Never
+    // fails for CONNECT_REQUEST and DISCONNECT.
+    bool enqueue(RType::Network::ReceivedMessage msg);
+    void tick(float dt);
+
+    // Set by the owning worker; sent to clients with every snapshot.
+    void setTimeScale(uint8_t percent) { _timeScale = percent; }
+
+    size_t getMemberCount() const { return _memberCount; }
+    size_t getEntityCount() const;
+    bool isIdle(std::chrono::seconds grace) const;
+
+private:
+    struct Member {
+        uint32_t player_id;
+        uint8_t slot;
+        std::string name;
+        bool ready = false;
+        bool compressSnapshots = false;     // negotiated at connect
+        std::chrono::steady_clock::time_point last_input{};
+    };
+
+    void handleMessage(const RType::Network::ReceivedMessage& msg);
+    void handleConnectRequest(const RType::Network::ReceivedMessage& msg);
+    void handleDisconnect(const RType::Network::ReceivedMessage& msg);
+    void handlePlayerInput(const RType::Network::ReceivedMessage& msg);
+    void handleReadyToPlay(const RType::Network::ReceivedMessage& msg);
+    void handleGameOn(const RType::Network::ReceivedMessage& msg);
+    void handleSnapshotAck(const RType::Network::ReceivedMessage& msg);
+
+    void removeMember(uint32_t connection_id);
+    void resetIfEmpty();
+    uint8_t findFreeSlot() const;
+
+    void broadcastGameState();
+    size_t snapshotBudgetBytes() const;
+    void sendSnapshot(uint32_t client_id, const Member& member,
+                      const RType::Network::EncodedPacket<sizeof(RType::Protocol::BatchedEntityUpdate)>& encoded);
+    void broadcastLobbyStatus();
+    bool areAllPlayersReady() const;
+    void broadcastScores();
+    void broadcastGameOver();
+    void broadcastEvent(const LocalGameEvent& event);
+    void broadcastNetworkEvent(const RType::Protocol::GameEvent& event);
+
+    template<typename T>
+    void broadcast(const T& packet, uint32_t exclude_id = 0) {
+        for (const auto& [connection_id, member] : _members) {
+            if (connection_id != exclude_id) {
+                _network.sendToClient(connection_id, packet);
+            }
+        }
+    }
+
+    // Game-state transitions (start, deaths, level changes, game over) go
+    // on the ordered channel so every client sees them in the order they
+    // happened.
+    template<typename T>
+    void broadcastOrdered(const T& packet) {
+        for (const auto& [connection_id, member] : _members) {
+            _network.sendOrdered(connection_id, packet);
+        }
+    }
+
+    uint32_t _id;
+    RType::Network::INetworkModule& _network;
+    GameModule _game;
+
+    RType::Core::SpscQueue<RType::Network::ReceivedMessage> _inbox;
+    std::mutex _controlMutex;
+    std::vector<RType::Network::ReceivedMessage> _control;
+    std::vector<RType::Network::ReceivedMessage> _controlDrain;     // worker only
+
+    std::atomic<size_t> _memberCount;
+    std::atomic<std::chrono::steady_clock::rep> _lastActivity;
+
+    // Keyed by NetworkModule connection id; the player id (slot + 1) is what
+    // the GameModule and the clients see.
+    std::map<uint32_t, Member> _members;
+    bool _slots[MAX_PLAYERS];
+
+    uint32_t _sequenceCounter;
+    uint8_t _timeScale;
+    float _snapshotAccumulator;
+    uint32_t _snapshotTick;
+    bool _gameStarted;
+    bool _gameOver;
+
+    // Delta Compression: what each client has acknowledged, so snapshots
+    // carry only entities that differ from it.
+    std::unordered_map<uint32_t, RType::Core::SnapshotBaseline<RType::Protocol::QuantizedEntityData>> _baselinesByClient;
+    // Entities that changed but did not fit a client's snapshot budget
+    // gain priority until they do.
+    std::unordered_map<uint32_t, RType::Core::PriorityAccumulator> _prioritiesByClient;
+
+    static constexpr size_t INBOX_CAPACITY = 1024;
+    static constexpr std::chrono::milliseconds MIN_INPUT_INTERVAL{16};  // ~60 FPS max
+    static constexpr float SNAPSHOT_DT = 1.0f / 20.0f;
+    static constexpr const char* SERVER_VERSION = "1.0.0";
+};
+
+} // namespace RType::Server
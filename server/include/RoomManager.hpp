@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Room.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace RType::Server {
+
+// Hosts many Rooms behind one NetworkModule. Rooms are sharded onto a fixed
+// pool of worker threads by id, so a given room is always ticked by the same
+// worker and never concurrently.
+class RoomManager {
+public:
+    RoomManager(RType::Network::INetworkModule& network, size_t workerCount, size_t maxRooms);
+    ~RoomManager();
+
+    void start();
+    void stop();
+
+    // Returns nullptr when the room does not exist and maxRooms is reached.
+    std::shared_ptr<Room> getOrCreateRoom(uint32_t room_id);
+    std::shared_ptr<Room> findRoom(uint32_t room_id) const;
+
+    void reapIdleRooms(std::chrono::seconds grace);
+
+    size_t getRoomCount() const;
+    size_t getEntityCount() const;
+    size_t getWorkerCount() const { return _workerCount; }
+
+private:
+    void workerLoop(size_t index);
+    void collectRooms(size_t index, std::vector<std::shared_ptr<Room>>& out) const;
+
+    RType::Network::INetworkModule& _network;
+    size_t _workerCount;
+    size_t _maxRooms;
+
+    std::unordered_map<uint32_t, std::shared_ptr<Room>> _rooms;
+    mutable std::mutex _roomsMutex;
+
+    std::atomic<bool> _running;
+    std::vector<std::thread> _workers;
+
+    static constexpr size_t MAX_CATCHUP_TICKS = 4;
+    static constexpr float TIME_SCALE_SMOOTHING = 0.05f;
+};
+
+} // namespace RType::Server
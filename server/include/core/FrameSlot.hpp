@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace RType::Core {
+
+// Holds the latest immutable frame published by one writer thread. Readers
+// on any thread get a shared_ptr that stays valid after the next publish.
+template<typename T>
+class FrameSlot {
+public:
+    void publish(std::shared_ptr<const T> frame)
+    {
+#if defined(__cpp_lib_atomic_shared_ptr)
+        _frame.store(std::move(frame), std::memory_order_release);
+#else
+        std::atomic_store_explicit(&_frame, std::move(frame), std::memory_order_release);
+#endif
+    }
+
+    std::shared_ptr<const T> load() const
+    {
+#if defined(__cpp_lib_atomic_shared_ptr)
+        return _frame.load(std::memory_order_acquire);
+#else
+        return std::atomic_load_explicit(&_frame, std::memory_order_acquire);
+#endif
+    }
+
+private:
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<std::shared_ptr<const T>> _frame;
+#else
+    std::shared_ptr<const T> _frame;
+#endif
+};
+
+} // namespace RType::Core
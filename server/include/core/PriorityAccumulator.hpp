@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace RType::Core {
+
+// Send priorities for one receiver. Each round, every item that wants to
+// go out adds its weight to its accumulated priority; items that are sent
+// drop back to zero and the rest keep what they built up. Low-weight items
+// are therefore delayed under a tight budget but never starved. Not
+// thread-safe.
+class PriorityAccumulator {
+public:
+    struct Candidate {
+        float priority;
+        uint32_t id;
+        size_t index;   // caller's handle, e.g. position in its snapshot
+    };
+
+    void beginRound() { _candidates.clear(); }
+
+    void add(uint32_t id, float weight, size_t index)
+    {
+        float& priority = _priorities[id];
+        priority += weight;
+        _candidates.push_back(Candidate{priority, id, index});
+    }
+
+    // This round's candidates, highest accumulated priority first.
+    const std::vector<Candidate>& ranked()
+    {
+        std::sort(_candidates.begin(), _candidates.end(),
+                  [](const Candidate& a, const Candidate& b) { return a.priority > b.priority; });
+        return _candidates;
+    }
+
+    void sent(uint32_t id) { _priorities.erase(id); }
+
+    // Drops the priority of every id for which keep(id) is false.
+    template<typename F>
+    void retain(F&& keep)
+    {
+        for (auto it = _priorities.begin(); it != _priorities.end();) {
+            if (keep(it->first))
+                ++it;
+            else
+                it = _priorities.erase(it);
+        }
+    }
+
+    float priority(uint32_t id) const
+    {
+        auto it = _priorities.find(id);
+        return it != _priorities.end() ? it->second : 0.f;
+    }
+
+private:
+    std::unordered_map<uint32_t, float> _priorities;
+    std::vector<Candidate> _candidates;
+};
+
+} // namespace RType::Core
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace RType::Core {
+
+// What one client is known to hold, for delta snapshots. Each snapshot
+// records the entity states and removals it carried; when the client acks
+// a tick, that snapshot's contents become the baseline. Later snapshots
+// compare against the baseline rather than against what was last sent, so
+// a lost snapshot is simply repeated until one gets through. An entity sent
+// since its baseline is pending: the client may hold either state, so it
+// keeps being sent until an ack settles it.
+//
+// The last HISTORY snapshots are kept; acks for anything older, or older
+// than an ack already applied, are ignored. Frame buffers keep their
+// capacity, so steady-state recording does not allocate. Not thread-safe.
+template<typename State>
+class SnapshotBaseline {
+public:
+    static constexpr size_t HISTORY = 32;
+
+    struct View {
+        const State* baseline = nullptr;    // nullptr: nothing confirmed
+        uint32_t baselineTick = 0;
+        bool pending = false;               // sent since the baseline
+    };
+
+    // Starts the record of snapshot tick, replacing the oldest one.
+    void begin(uint32_t tick)
+    {
+        _current = &_frames[tick % HISTORY];
+        _current->tick = tick;
+        _current->valid = true;
+        _current->entries.clear();
+    }
+
+    void sent(uint32_t id, const State& state)
+    {
+        _current->entries.push_back(Entry{id, state, false});
+        Known& known = _known[id];
+        known.removals = 0;
+        known.lastSent = _current->tick;
+        known.pending = true;
+    }
+
+    // A client that never acks is not told about a removal forever: after
+    // HISTORY attempts the entity is forgotten.
+    void removed(uint32_t id)
+    {
+        _current->entries.push_back(Entry{id, State{}, true});
+        auto it = _known.find(id);
+        if (it == _known.end())
+            return;
+        // If the id comes back before the removal is acked, the client may
+        // or may not still have the old entity: start it from scratch.
+        it->second.confirmed = false;
+        if (++it->second.removals >= HISTORY)
+            _known.erase(it);
+    }
+
+    void acknowledge(uint32_t tick)
+    {
+        if (_hasAcked && static_cast<int32_t>(tick - _ackedTick) <= 0)
+            return;
+        Frame& frame = _frames[tick % HISTORY];
+        if (!frame.valid || frame.tick != tick)
+            return;
+        _hasAcked = true;
+        _ackedTick = tick;
+        frame.valid = false;
+
+        for (const Entry& entry : frame.entries) {
+            if (entry.removed) {
+                _known.erase(entry.id);
+            } else {
+                Known& known = _known[entry.id];
+                known.state = entry.state;
+                known.confirmed = true;
+                known.confirmedTick = tick;
+                known.pending = known.lastSent != tick;
+            }
+        }
+    }
+
+    // The client could not apply id, so its baseline is worthless: send it
+    // whole until an ack confirms a new one.
+    void resync(uint32_t id)
+    {
+        auto it = _known.find(id);
+        if (it == _known.end())
+            return;
+        it->second.confirmed = false;
+        it->second.pending = true;
+    }
+
+    // The state the client confirmed for id, or nullptr if it has none yet.
+    const State* baseline(uint32_t id) const { return find(id).baseline; }
+
+    View find(uint32_t id) const
+    {
+        View view;
+        auto it = _known.find(id);
+        if (it == _known.end())
+            return view;
+        if (it->second.confirmed) {
+            view.baseline = &it->second.state;
+            view.baselineTick = it->second.confirmedTick;
+        }
+        view.pending = it->second.pending;
+        return view;
+    }
+
+    // Calls f(id) for every entity the client may hold: anything sent and
+    // not yet confirmed removed.
+    template<typename F>
+    void forEachKnown(F&& f) const
+    {
+        for (const auto& [id, known] : _known)
+            f(id);
+    }
+
+    size_t knownCount() const { return _known.size(); }
+
+private:
+    struct Entry {
+        uint32_t id;
+        State state;
+        bool removed;
+    };
+
+    struct Frame {
+        uint32_t tick = 0;
+        bool valid = false;
+        std::vector<Entry> entries;
+    };
+
+    struct Known {
+        State state{};
+        bool confirmed = false;
+        uint32_t confirmedTick = 0;
+        uint32_t lastSent = 0;
+        bool pending = false;
+        size_t removals = 0;
+    };
+
+    Frame _frames[HISTORY];
+    Frame* _current = nullptr;
+    std::unordered_map<uint32_t, Known> _known;
+    uint32_t _ackedTick = 0;
+    bool _hasAcked = false;
+};
+
+} // namespace RType::Core
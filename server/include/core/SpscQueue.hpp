@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace RType::Core {
+
+// Bounded lock-free single-producer / single-consumer ring buffer.
+// Exactly one thread may call tryPush() and exactly one (other) thread may
+// call tryPop(); size() is only an estimate when called from elsewhere.
+template<typename T>
+class SpscQueue {
+public:
+    // Capacity is rounded up to a power of two.
+    explicit SpscQueue(size_t capacity)
+        : _capacity(roundUp(capacity))
+        , _mask(_capacity - 1)
+        , _slots(std::make_unique<T[]>(_capacity))
+        , _head(0)
+        , _tail(0)
+    {
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    bool tryPush(T&& value)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == _capacity) {
+            return false;
+        }
+        _slots[tail & _mask] = std::move(value);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& out)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        out = std::move(_slots[head & _mask]);
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const
+    {
+        return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return _capacity; }
+
+private:
+    static size_t roundUp(size_t value)
+    {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    static constexpr size_t CACHE_LINE = 64;
+
+    const size_t _capacity;
+    const size_t _mask;
+    std::unique_ptr<T[]> _slots;
+
+    // Producer and consumer indices live on separate cache lines so the two
+    // threads do not false-share.
+    alignas(CACHE_LINE) std::atomic<size_t> _head;
+    alignas(CACHE_LINE) std::atomic<size_t> _tail;
+};
+
+} // namespace RType::Core
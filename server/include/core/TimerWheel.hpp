@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RType::Core {
+
+// Hashed timing wheel with fixed-resolution slots. Each slot holds an
+// intrusive doubly linked list of timers, so schedule() and cancel() are
+// O(1) and advance() only visits the slots that elapsed, whatever the
+// number of timers in flight. Deadlines further out than one revolution
+// wait in their slot for the right round. Not thread-safe.
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Handle = uint64_t;
+
+    static constexpr Handle INVALID_HANDLE = 0;
+
+    explicit TimerWheel(size_t slotCount = 1024,
+                        std::chrono::milliseconds resolution = std::chrono::milliseconds(1),
+                        Clock::time_point start = Clock::now())
+        : _slots(roundUp(slotCount), NIL)
+        , _mask(_slots.size() - 1)
+        , _resolution(resolution)
+        , _start(start)
+        , _currentTick(0)
+        , _freeHead(NIL)
+        , _active(0)
+    {
+    }
+
+    // Fires payload once now >= deadline (rounded up to the next slot).
+    Handle schedule(Clock::time_point deadline, uint64_t payload)
+    {
+        uint64_t tick = tickOf(deadline);
+        if (tick <= _currentTick) {
+            tick = _currentTick + 1;
+        }
+
+        uint32_t index = allocate();
+        Node& node = _nodes[index];
+        node.deadline = tick;
+        node.payload = payload;
+        node.slot = static_cast<uint32_t>(tick & _mask);
+        node.active = true;
+        link(index);
+        ++_active;
+
+        return (static_cast<Handle>(node.generation) << 32) | (index + 1);
+    }
+
+    // Returns false if the timer already fired or was cancelled.
+    bool cancel(Handle handle)
+    {
+        if (handle == INVALID_HANDLE) {
+            return false;
+        }
+        uint32_t index = static_cast<uint32_t>(handle & 0xFFFFFFFFu) - 1;
+        if (index >= _nodes.size()) {
+            return false;
+        }
+        Node& node = _nodes[index];
+        if (!node.active || node.generation != static_cast<uint32_t>(handle >> 32)) {
+            return false;
+        }
+        unlink(index);
+        release(index);
+        return true;
+    }
+
+    // Fires every timer due at or before now. Callbacks run after the
+    // expired timers are unlinked, so they may schedule or cancel freely.
+    template<typename F>
+    void advance(Clock::time_point now, F&& onExpire)
+    {
+        uint64_t target = tickOf(now);
+        if (target < _currentTick) {
+            return;
+        }
+
+        _expired.clear();
+        if (_active > 0) {
+            // After a long stall, one pass over every slot is enough.
+            uint64_t from = _currentTick;
+            if (target - from >= _slots.size()) {
+                from = target - _slots.size();
+            }
+            for (uint64_t tick = from + 1; tick <= target; ++tick) {
+                collect(static_cast<uint32_t>(tick & _mask), target);
+            }
+        }
+        _currentTick = target;
+
+        for (uint64_t payload : _expired) {
+            onExpire(payload);
+        }
+    }
+
+    // When the earliest timer is due, rounded up to its slot like
+    // schedule() does, or Clock::time_point::max() if none is pending.
+    // Walks the slots in order from the current one, so it costs at most
+    // one revolution: meant for deciding how long to sleep.
+    Clock::time_point nextDeadline() const
+    {
+        if (_active == 0) {
+            return Clock::time_point::max();
+        }
+        // Every timer in a slot is due at or after that slot's next tick,
+        // so the first slot at or beyond the best deadline ends the walk.
+        uint64_t best = UINT64_MAX;
+        for (uint64_t tick = _currentTick + 1; tick <= _currentTick + _slots.size() && tick < best; ++tick) {
+            for (uint32_t index = _slots[tick & _mask]; index != NIL; index = _nodes[index].next) {
+                best = std::min(best, _nodes[index].deadline);
+            }
+        }
+        return _start + _resolution * static_cast<Clock::rep>(best);
+    }
+
+    size_t size() const { return _active; }
+    bool empty() const { return _active == 0; }
+
+private:
+    static constexpr uint32_t NIL = 0xFFFFFFFFu;
+
+    struct Node {
+        uint64_t deadline = 0;
+        uint64_t payload = 0;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        uint32_t slot = 0;
+        uint32_t generation = 0;
+        bool active = false;
+    };
+
+    static size_t roundUp(size_t value)
+    {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    uint64_t tickOf(Clock::time_point time) const
+    {
+        if (time <= _start) {
+            return 0;
+        }
+        auto elapsed = time - _start;
+        auto ticks = (elapsed + _resolution - Clock::duration(1)) / _resolution;
+        return static_cast<uint64_t>(ticks);
+    }
+
+    uint32_t allocate()
+    {
+        if (_freeHead != NIL) {
+            uint32_t index = _freeHead;
+            _freeHead = _nodes[index].next;
+            return index;
+        }
+        _nodes.emplace_back();
+        return static_cast<uint32_t>(_nodes.size() - 1);
+    }
+
+    void release(uint32_t index)
+    {
+        Node& node = _nodes[index];
+        node.active = false;
+        ++node.generation;
+        node.next = _freeHead;
+        _freeHead = index;
+        --_active;
+    }
+
+    void link(uint32_t index)
+    {
+        Node& node = _nodes[index];
+        node.prev = NIL;
+        node.next = _slots[node.slot];
+        if (node.next != NIL) {
+            _nodes[node.next].prev = index;
+        }
+        _slots[node.slot] = index;
+    }
+
+    void unlink(uint32_t index)
+    {
+        Node& node = _nodes[index];
+        if (node.prev != NIL) {
+            _nodes[node.prev].next = node.next;
+        } else {
+            _slots[node.slot] = node.next;
+        }
+        if (node.next != NIL) {
+            _nodes[node.next].prev = node.prev;
+        }
+    }
+
+    void collect(uint32_t slot, uint64_t target)
+    {
+        uint32_t index = _slots[slot];
+        while (index != NIL) {
+            uint32_t next = _nodes[index].next;
+            if (_nodes[index].deadline <= target) {
+                _expired.push_back(_nodes[index].payload);
+                unlink(index);
+                release(index);
+            }
+            index = next;
+        }
+    }
+
+    std::vector<uint32_t> _slots;
+    std::vector<Node> _nodes;
+    std::vector<uint64_t> _expired;
+    const size_t _mask;
+    const Clock::duration _resolution;
+    const Clock::time_point _start;
+    uint64_t _currentTick;
+    uint32_t _freeHead;
+    size_t _active;
+};
+
+} // namespace RType::Core
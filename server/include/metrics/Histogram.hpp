@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace RType::Metrics {
+
+// Lock-free latency histogram with a fixed number of microsecond buckets,
+// whose bounds are chosen at construction. Observations are relaxed atomic
+// increments so it can be shared by every worker thread.
+class Histogram {
+public:
+    using Bounds = std::array<uint64_t, 12>;
+
+    // Tick and phase timings: 25 us to 66 ms, a 60 Hz tick is 16.7 ms.
+    static constexpr Bounds TICK_BOUNDS_US = {
+        25, 50, 100, 250, 500, 1000, 2000, 4000, 8000, 16000, 33000, 66000
+    };
+    // Round trips and retransmit timeouts: 1 ms (LAN) to 4 s (past MAX_RTO).
+    static constexpr Bounds NETWORK_BOUNDS_US = {
+        1000, 2000, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 2000000, 4000000
+    };
+    static constexpr size_t BUCKET_COUNT = Bounds{}.size() + 1;
+
+    explicit Histogram(const Bounds& bounds = TICK_BOUNDS_US)
+        : _bounds(bounds)
+    {
+    }
+
+    void observe(uint64_t micros)
+    {
+        size_t bucket = 0;
+        while (bucket < _bounds.size() && micros > _bounds[bucket]) {
+            ++bucket;
+        }
+        _buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        _sum.fetch_add(micros, std::memory_order_relaxed);
+        _count.fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t max = _max.load(std::memory_order_relaxed);
+        while (micros > max && !_max.compare_exchange_weak(max, micros, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const { return _count.load(std::memory_order_relaxed); }
+    uint64_t sum() const { return _sum.load(std::memory_order_relaxed); }
+    uint64_t max() const { return _max.load(std::memory_order_relaxed); }
+
+    // Estimates the q-quantile (0..1) in microseconds by interpolating
+    // inside the bucket that contains it.
+    double percentile(double q) const
+    {
+        uint64_t total = count();
+        if (total == 0) {
+            return 0.0;
+        }
+
+        double rank = q * static_cast<double>(total);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            uint64_t inBucket = _buckets[i].load(std::memory_order_relaxed);
+            if (inBucket == 0) {
+                continue;
+            }
+            if (static_cast<double>(seen + inBucket) >= rank) {
+                double lower = (i == 0) ? 0.0 : static_cast<double>(_bounds[i - 1]);
+                double upper = (i < _bounds.size()) ? static_cast<double>(_bounds[i])
+                                                       : static_cast<double>(max());
+                double fraction = (rank - static_cast<double>(seen)) / static_cast<double>(inBucket);
+                return lower + (upper - lower) * fraction;
+            }
+            seen += inBucket;
+        }
+        return static_cast<double>(max());
+    }
+
+    // Writes a Prometheus histogram in seconds, as the exposition format expects.
+    void writePrometheus(std::ostream& out, const std::string& name, const std::string& labels = "") const
+    {
+        std::string sep = labels.empty() ? "" : ",";
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < _bounds.size(); ++i) {
+            cumulative += _buckets[i].load(std::memory_order_relaxed);
+            out << name << "_bucket{" << labels << sep << "le=\""
+                << static_cast<double>(_bounds[i]) / 1e6 << "\"} " << cumulative << "\n";
+        }
+        cumulative += _buckets[_bounds.size()].load(std::memory_order_relaxed);
+        out << name << "_bucket{" << labels << sep << "le=\"+Inf\"} " << cumulative << "\n";
+
+        std::string braces = labels.empty() ? "" : "{" + labels + "}";
+        out << name << "_sum" << braces << " " << static_cast<double>(sum()) / 1e6 << "\n";
+        out << name << "_count" << braces << " " << count() << "\n";
+    }
+
+private:
+    const Bounds _bounds;
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> _buckets{};
+    std::atomic<uint64_t> _sum{0};
+    std::atomic<uint64_t> _count{0};
+    std::atomic<uint64_t> _max{0};
+};
+
+} // namespace RType::Metrics
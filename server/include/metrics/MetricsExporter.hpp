@@ -0,0 +1,49 @@
+#pragma once
+
+#include "metrics/ServerMetrics.hpp"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace RType::Metrics {
+
+// Publishes ServerMetrics in Prometheus text format two ways:
+//  - a file rewritten every interval (write to .tmp, then rename, so the
+//    node_exporter textfile collector never sees a partial file);
+//  - a local Unix-domain stream socket that answers one command per
+//    connection: "metrics" (or an empty line) for a fresh rendering, or
+//    "profile N" for the profiler's last N ticks when it is compiled in.
+// Either path may be empty to disable it.
+class MetricsExporter {
+public:
+    MetricsExporter(ServerMetrics& metrics,
+                    std::string filePath,
+                    std::string socketPath,
+                    std::chrono::milliseconds interval = std::chrono::seconds(5));
+    ~MetricsExporter();
+
+    bool start();
+    void stop();
+
+private:
+    void exportLoop();
+    bool openSocket();
+    void serveClient(int fd);
+    std::string handleCommand(const std::string& command);
+    void writeFile();
+
+    ServerMetrics& _metrics;
+    std::string _filePath;
+    std::string _socketPath;
+    std::chrono::milliseconds _interval;
+
+    int _listenFd;
+    std::atomic<bool> _running;
+    std::thread _thread;
+
+    static constexpr int COMMAND_TIMEOUT_MS = 200;
+    static constexpr size_t MAX_COMMAND_SIZE = 256;
+};
+
+} // namespace RType::Metrics
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "metrics/ServerMetrics.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+namespace RType::Metrics {
+
+// Per-tick phase breakdown recorded by the profiler, in raw clock ticks.
+struct TickRecord {
+    uint32_t room_id = 0;
+    uint64_t total = 0;
+    std::array<uint64_t, PHASE_COUNT> phases{};
+};
+
+// Keeps the last CAPACITY room ticks in a ring buffer so a tick overrun
+// can be attributed to the phase that caused it after the fact. Scopes
+// only touch a thread-local record; the ring lock is taken once per tick.
+class Profiler {
+public:
+    static constexpr size_t CAPACITY = 4096;
+
+    static Profiler& instance();
+
+    static uint64_t now()
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    void commit(const TickRecord& record);
+
+    // Human-readable dump of the last n ticks plus per-phase p50/p99/max
+    // over the whole ring, in microseconds.
+    std::string dump(size_t n) const;
+
+private:
+    Profiler();
+
+    double ticksPerMicro() const;
+
+    std::vector<TickRecord> _ring;
+    size_t _head;
+    size_t _size;
+    uint64_t _committed;
+    mutable std::mutex _mutex;
+
+    uint64_t _calibrationTicks;
+    std::chrono::steady_clock::time_point _calibrationTime;
+};
+
+inline thread_local TickRecord* t_currentTick = nullptr;
+
+// Opens a tick record for the current thread; committed on destruction.
+class ProfileTick {
+public:
+    explicit ProfileTick(uint32_t room_id)
+        : _start(Profiler::now())
+    {
+        _record.room_id = room_id;
+        t_currentTick = &_record;
+    }
+
+    ~ProfileTick()
+    {
+        _record.total = Profiler::now() - _start;
+        t_currentTick = nullptr;
+        Profiler::instance().commit(_record);
+    }
+
+    ProfileTick(const ProfileTick&) = delete;
+    ProfileTick& operator=(const ProfileTick&) = delete;
+
+private:
+    TickRecord _record;
+    uint64_t _start;
+};
+
+// Adds the lifetime of the scope to the given phase of the open tick.
+class ProfileScope {
+public:
+    explicit ProfileScope(Phase phase)
+        : _phase(phase)
+        , _start(Profiler::now())
+    {
+    }
+
+    ~ProfileScope()
+    {
+        if (t_currentTick) {
+            t_currentTick->phases[static_cast<size_t>(_phase)] += Profiler::now() - _start;
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Phase _phase;
+    uint64_t _start;
+};
+
+} // namespace RType::Metrics
+
+// The profiler is opt-in (cmake -DRTYPE_ENABLE_PROFILER=ON); otherwise the
+// macros expand to nothing.
+#define RTYPE_PROFILE_CONCAT_INNER(a, b) a##b
+#define RTYPE_PROFILE_CONCAT(a, b) RTYPE_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef RTYPE_PROFILER
+#define RTYPE_PROFILE_TICK(room_id) \
+    ::RType::Metrics::ProfileTick RTYPE_PROFILE_CONCAT(rtypeProfileTick_, __LINE__)(room_id)
+#define RTYPE_PROFILE_SCOPE(phase) \
+    ::RType::Metrics::ProfileScope RTYPE_PROFILE_CONCAT(rtypeProfileScope_, __LINE__)(phase)
+#else
+#define RTYPE_PROFILE_TICK(room_id) ((void)0)
+#define RTYPE_PROFILE_SCOPE(phase) ((void)0)
+#endif
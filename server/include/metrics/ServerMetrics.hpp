@@ -0,0 +1,196 @@
+#pragma once
+
+#include "metrics/Histogram.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace RType::Metrics {
+
+// Phases of a room tick, in execution order, as recorded by the opt-in
+// profiler (metrics/Profiler.hpp). Everything between INBOX and SNAPSHOT
+// runs inside GameModule::update.
+enum class Phase : uint8_t {
+    INBOX,
+    LEVEL_UPDATE,
+    MOVEMENT,
+    CLAMP,
+    COOLDOWNS,
+    BOSS_CHECK,
+    CHARGE_STATES,
+    ENEMIES,
+    COLLISIONS,
+    PROJECTILE_CLEANUP,
+    REGISTRY_CLEANUP,
+    SNAPSHOT,
+    COUNT
+};
+
+constexpr size_t PHASE_COUNT = static_cast<size_t>(Phase::COUNT);
+
+const char* phaseName(Phase phase);
+const char* packetTypeName(uint8_t type);
+
+// Process-wide server counters. Everything is atomic and relaxed: writers
+// are the network threads and room workers, the only reader is the exporter.
+class ServerMetrics {
+public:
+    static ServerMetrics& instance();
+
+    void recordPacketIn(uint8_t type, size_t bytes)
+    {
+        _packetsIn[type].fetch_add(1, std::memory_order_relaxed);
+        _bytesIn[type].fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void recordPacketOut(uint8_t type, size_t bytes)
+    {
+        _packetsOut[type].fetch_add(1, std::memory_order_relaxed);
+        _bytesOut[type].fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void recordQueueDepth(size_t depth)
+    {
+        _queueDepth.store(depth, std::memory_order_relaxed);
+        raiseMax(_queueDepthMax, depth);
+    }
+
+    void recordInboxDepth(size_t depth) { raiseMax(_inboxDepthMax, depth); }
+    void recordInboxDropped() { _inboxDropped.fetch_add(1, std::memory_order_relaxed); }
+
+    void recordTicksBehind(size_t ticks) { raiseMax(_ticksBehindMax, ticks); }
+    void recordCatchUpTicks(size_t ticks) { _catchUpTicks.fetch_add(ticks, std::memory_order_relaxed); }
+    void recordTicksSkipped(size_t ticks) { _ticksSkipped.fetch_add(ticks, std::memory_order_relaxed); }
+    void recordTimeScale(uint8_t percent) { lowerMin(_timeScaleMin, percent); }
+
+    void recordPoolExhausted() { _poolExhausted.fetch_add(1, std::memory_order_relaxed); }
+    void recordSendCall() { _sendCalls.fetch_add(1, std::memory_order_relaxed); }
+    void recordRecvCall() { _recvCalls.fetch_add(1, std::memory_order_relaxed); }
+
+    void recordRetransmit() { _retransmits.fetch_add(1, std::memory_order_relaxed); }
+    void recordReliableDropped() { _reliableDropped.fetch_add(1, std::memory_order_relaxed); }
+    void recordFragmented(size_t fragments)
+    {
+        _messagesFragmented.fetch_add(1, std::memory_order_relaxed);
+        _fragmentsSent.fetch_add(fragments, std::memory_order_relaxed);
+    }
+    void recordBundle(size_t messages)
+    {
+        _bundlesSent.fetch_add(1, std::memory_order_relaxed);
+        _messagesBundled.fetch_add(messages, std::memory_order_relaxed);
+    }
+    void recordReassemblyDropped(uint64_t messages) { _reassemblyDropped.fetch_add(messages, std::memory_order_relaxed); }
+
+    void recordSnapshotDeferred(size_t entities) { _snapshotDeferred.fetch_add(entities, std::memory_order_relaxed); }
+    // compressed is 0 when compression did not pay and the body went out as it was.
+    void recordSnapshotCompression(size_t uncompressed, size_t compressed)
+    {
+        _snapshotBytesUncompressed.fetch_add(uncompressed, std::memory_order_relaxed);
+        if (compressed == 0) {
+            _snapshotsUncompressed.fetch_add(1, std::memory_order_relaxed);
+            _snapshotBytesSent.fetch_add(uncompressed, std::memory_order_relaxed);
+        } else {
+            _snapshotsCompressed.fetch_add(1, std::memory_order_relaxed);
+            _snapshotBytesSent.fetch_add(compressed, std::memory_order_relaxed);
+        }
+    }
+
+    void setRooms(size_t rooms) { _rooms.store(rooms, std::memory_order_relaxed); }
+    void setClients(size_t clients) { _clients.store(clients, std::memory_order_relaxed); }
+    void setEntities(size_t entities) { _entities.store(entities, std::memory_order_relaxed); }
+
+    Histogram& workerTick() { return _workerTick; }
+    Histogram& roomTick() { return _roomTick; }
+    Histogram& phase(Phase p) { return _phases[static_cast<size_t>(p)]; }
+    Histogram& retransmitLateness() { return _retransmitLateness; }
+    Histogram& peerRtt() { return _peerRtt; }
+    Histogram& retransmitTimeout() { return _retransmitTimeout; }
+
+    // Prometheus text exposition. With resetPeaks the max gauges restart
+    // from zero so the periodic export reports the peak per interval.
+    void writePrometheus(std::ostream& out, bool resetPeaks);
+
+private:
+    ServerMetrics() = default;
+
+    static void lowerMin(std::atomic<uint64_t>& target, uint64_t value)
+    {
+        uint64_t current = target.load(std::memory_order_relaxed);
+        while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    static void raiseMax(std::atomic<uint64_t>& target, uint64_t value)
+    {
+        uint64_t current = target.load(std::memory_order_relaxed);
+        while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    std::array<std::atomic<uint64_t>, 256> _packetsIn{};
+    std::array<std::atomic<uint64_t>, 256> _bytesIn{};
+    std::array<std::atomic<uint64_t>, 256> _packetsOut{};
+    std::array<std::atomic<uint64_t>, 256> _bytesOut{};
+
+    std::atomic<uint64_t> _queueDepth{0};
+    std::atomic<uint64_t> _queueDepthMax{0};
+    std::atomic<uint64_t> _inboxDepthMax{0};
+    std::atomic<uint64_t> _inboxDropped{0};
+    std::atomic<uint64_t> _ticksBehindMax{0};
+    std::atomic<uint64_t> _catchUpTicks{0};
+    std::atomic<uint64_t> _ticksSkipped{0};
+    std::atomic<uint64_t> _timeScaleMin{100};
+    std::atomic<uint64_t> _poolExhausted{0};
+    std::atomic<uint64_t> _sendCalls{0};
+    std::atomic<uint64_t> _recvCalls{0};
+    std::atomic<uint64_t> _retransmits{0};
+    std::atomic<uint64_t> _reliableDropped{0};
+    std::atomic<uint64_t> _messagesFragmented{0};
+    std::atomic<uint64_t> _fragmentsSent{0};
+    std::atomic<uint64_t> _reassemblyDropped{0};
+    std::atomic<uint64_t> _bundlesSent{0};
+    std::atomic<uint64_t> _messagesBundled{0};
+    std::atomic<uint64_t> _snapshotDeferred{0};
+    std::atomic<uint64_t> _snapshotsCompressed{0};
+    std::atomic<uint64_t> _snapshotsUncompressed{0};
+    std::atomic<uint64_t> _snapshotBytesUncompressed{0};
+    std::atomic<uint64_t> _snapshotBytesSent{0};
+    std::atomic<uint64_t> _rooms{0};
+    std::atomic<uint64_t> _clients{0};
+    std::atomic<uint64_t> _entities{0};
+
+    Histogram _workerTick;
+    Histogram _roomTick;
+    std::array<Histogram, PHASE_COUNT> _phases;
+    Histogram _retransmitLateness;
+    Histogram _peerRtt{Histogram::NETWORK_BOUNDS_US};
+    Histogram _retransmitTimeout{Histogram::NETWORK_BOUNDS_US};
+};
+
+// Adds the lifetime of the scope to a histogram.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram& histogram)
+        : _histogram(histogram)
+        , _start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~ScopedTimer()
+    {
+        auto elapsed = std::chrono::steady_clock::now() - _start;
+        _histogram.observe(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Histogram& _histogram;
+    std::chrono::steady_clock::time_point _start;
+};
+
+} // namespace RType::Metrics
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace RType::Network {
+
+// Number of bits needed to hold any value in [0, range].
+constexpr unsigned bitsRequired(uint64_t range)
+{
+    unsigned bits = 0;
+    while (range > 0) {
+        ++bits;
+        range >>= 1;
+    }
+    return bits;
+}
+
+// Bit-packed serialization. A message declares a single
+//
+//     template<typename Stream> bool serialize(Stream& stream);
+//
+// made of stream.serializeXxx() calls, and the same function writes it
+// through a BitWriter or reads it back through a BitReader. Every call
+// returns false once the stream has failed, so serialize() can chain them
+// with &&. Bits are packed least significant first into a caller-owned
+// buffer; neither stream allocates.
+//
+// Reads are bounds-checked: running past the end of the buffer, a value
+// outside its declared range or an over-long string fails the stream, and
+// the failure is sticky.
+//
+// A BitWriter over a null buffer stores nothing and only measures, so a
+// caller can size a message before committing it to a budget.
+class BitWriter {
+public:
+    static constexpr bool IsWriting = true;
+    static constexpr bool IsReading = false;
+
+    BitWriter(uint8_t* buffer, size_t capacity)
+        : _buffer(buffer)
+        , _capacity(capacity)
+    {
+    }
+
+    bool serializeBits(uint32_t& value, unsigned bits)
+    {
+        if (_failed)
+            return false;
+        uint64_t mask = bits >= 32 ? 0xFFFFFFFFull : ((uint64_t{1} << bits) - 1);
+        _scratch |= (static_cast<uint64_t>(value) & mask) << _scratchBits;
+        _scratchBits += bits;
+        while (_scratchBits >= 8) {
+            if (_bytes == _capacity)
+                return fail();
+            if (_buffer)
+                _buffer[_bytes] = static_cast<uint8_t>(_scratch);
+            ++_bytes;
+            _scratch >>= 8;
+            _scratchBits -= 8;
+        }
+        return true;
+    }
+
+    bool serializeBool(bool& value)
+    {
+        uint32_t bit = value ? 1 : 0;
+        return serializeBits(bit, 1);
+    }
+
+    // Any integer or enum in [min, max], in bitsRequired(max - min) bits.
+    // The range may span at most 32 bits.
+    template<typename T>
+    bool serializeInt(T& value, int64_t min, int64_t max)
+    {
+        auto wide = static_cast<int64_t>(value);
+        if (wide < min || wide > max || bitsRequired(static_cast<uint64_t>(max - min)) > 32)
+            return fail();
+        auto offset = static_cast<uint32_t>(wide - min);
+        return serializeBits(offset, bitsRequired(static_cast<uint64_t>(max - min)));
+    }
+
+    // 7 bits per group plus a continuation bit: small values stay small.
+    bool serializeVarint(uint32_t& value)
+    {
+        uint32_t rest = value;
+        do {
+            uint32_t group = rest & 0x7F;
+            rest >>= 7;
+            uint32_t more = rest != 0 ? 1 : 0;
+            if (!serializeBits(group, 7) || !serializeBits(more, 1))
+                return false;
+        } while (rest != 0);
+        return true;
+    }
+
+    // value is clamped to [min, max] and rounded to a multiple of
+    // resolution above min.
+    bool serializeFloat(float& value, float min, float max, float resolution)
+    {
+        auto steps = static_cast<uint32_t>(std::ceil((max - min) / resolution));
+        float clamped = std::clamp(value, min, max);
+        auto quantized = static_cast<uint32_t>(std::lround((clamped - min) / resolution));
+        return serializeBits(quantized, bitsRequired(steps));
+    }
+
+    // A nul-terminated string of at most capacity - 1 characters.
+    bool serializeString(char* text, size_t capacity)
+    {
+        auto length = static_cast<size_t>(std::find(text, text + capacity - 1, '\0') - text);
+        if (!serializeInt(length, 0, static_cast<int64_t>(capacity - 1)))
+            return false;
+        for (size_t i = 0; i < length; ++i) {
+            uint32_t byte = static_cast<uint8_t>(text[i]);
+            if (!serializeBits(byte, 8))
+                return false;
+        }
+        return true;
+    }
+
+    // Pads the last byte with zero bits; call once before bytesWritten().
+    bool flush()
+    {
+        if (_failed)
+            return false;
+        if (_scratchBits > 0) {
+            if (_bytes == _capacity)
+                return fail();
+            if (_buffer)
+                _buffer[_bytes] = static_cast<uint8_t>(_scratch);
+            ++_bytes;
+            _scratch = 0;
+            _scratchBits = 0;
+        }
+        return true;
+    }
+
+    size_t bytesWritten() const { return _bytes; }
+    size_t bitsWritten() const { return _bytes * 8 + _scratchBits; }
+    bool failed() const { return _failed; }
+
+private:
+    bool fail()
+    {
+        _failed = true;
+        return false;
+    }
+
+    uint8_t* _buffer;
+    size_t _capacity;
+    size_t _bytes = 0;
+    uint64_t _scratch = 0;
+    unsigned _scratchBits = 0;
+    bool _failed = false;
+};
+
+class BitReader {
+public:
+    static constexpr bool IsWriting = false;
+    static constexpr bool IsReading = true;
+
+    BitReader(const uint8_t* buffer, size_t size)
+        : _buffer(buffer)
+        , _size(size)
+    {
+    }
+
+    bool serializeBits(uint32_t& value, unsigned bits)
+    {
+        if (_failed)
+            return false;
+        while (_scratchBits < bits) {
+            if (_bytes == _size)
+                return fail();
+            _scratch |= static_cast<uint64_t>(_buffer[_bytes++]) << _scratchBits;
+            _scratchBits += 8;
+        }
+        uint64_t mask = bits >= 32 ? 0xFFFFFFFFull : ((uint64_t{1} << bits) - 1);
+        value = static_cast<uint32_t>(_scratch & mask);
+        _scratch >>= bits;
+        _scratchBits -= bits;
+        return true;
+    }
+
+    bool serializeBool(bool& value)
+    {
+        uint32_t bit = 0;
+        if (!serializeBits(bit, 1))
+            return false;
+        value = bit != 0;
+        return true;
+    }
+
+    template<typename T>
+    bool serializeInt(T& value, int64_t min, int64_t max)
+    {
+        if (bitsRequired(static_cast<uint64_t>(max - min)) > 32)
+            return fail();
+        uint32_t offset = 0;
+        if (!serializeBits(offset, bitsRequired(static_cast<uint64_t>(max - min))))
+            return false;
+        int64_t wide = min + static_cast<int64_t>(offset);
+        if (wide > max)
+            return fail();
+        value = static_cast<T>(wide);
+        return true;
+    }
+
+    bool serializeVarint(uint32_t& value)
+    {
+        uint32_t result = 0;
+        for (unsigned shift = 0; shift < 35; shift += 7) {
+            uint32_t group = 0;
+            uint32_t more = 0;
+            if (!serializeBits(group, 7) || !serializeBits(more, 1))
+                return false;
+            if (shift == 28 && group > 0x0F)
+                return fail();
+            result |= group << shift;
+            if (!more) {
+                value = result;
+                return true;
+            }
+        }
+        return fail();
+    }
+
+    bool serializeFloat(float& value, float min, float max, float resolution)
+    {
+        auto steps = static_cast<uint32_t>(std::ceil((max - min) / resolution));
+        uint32_t quantized = 0;
+        if (!serializeBits(quantized, bitsRequired(steps)))
+            return false;
+        if (quantized > steps)
+            return fail();
+        value = std::min(min + static_cast<float>(quantized) * resolution, max);
+        return true;
+    }
+
+    bool serializeString(char* text, size_t capacity)
+    {
+        size_t length = 0;
+        if (!serializeInt(length, 0, static_cast<int64_t>(capacity - 1)))
+            return false;
+        for (size_t i = 0; i < length; ++i) {
+            uint32_t byte = 0;
+            if (!serializeBits(byte, 8))
+                return false;
+            text[i] = static_cast<char>(byte);
+        }
+        std::memset(text + length, 0, capacity - length);
+        return true;
+    }
+
+    // Bytes consumed so far, counting a partly read byte.
+    size_t bytesRead() const { return _bytes; }
+    bool failed() const { return _failed; }
+
+private:
+    bool fail()
+    {
+        _failed = true;
+        return false;
+    }
+
+    const uint8_t* _buffer;
+    size_t _size;
+    size_t _bytes = 0;
+    uint64_t _scratch = 0;
+    unsigned _scratchBits = 0;
+    bool _failed = false;
+};
+
+// A message ready for the INetworkModule send templates: its header copied
+// as-is, then its serialize() output. getPacketSize() makes the templates
+// send only the bytes in use.
+template<size_t Capacity>
+struct EncodedPacket {
+    uint8_t bytes[Capacity];
+    size_t size = 0;
+
+    size_t getPacketSize() const { return size; }
+};
+
+// Header bytes first, so the receiver can validate and route the packet
+// before decoding the body. The body may be at most Capacity minus the
+// header; returns false if it does not fit.
+template<typename T, size_t Capacity>
+bool encode(const T& message, EncodedPacket<Capacity>& out)
+{
+    static_assert(Capacity > sizeof(message.header), "no room for a body");
+    std::memcpy(out.bytes, &message.header, sizeof(message.header));
+    BitWriter writer(out.bytes + sizeof(message.header), Capacity - sizeof(message.header));
+    // serialize() only reads the message when writing.
+    if (!const_cast<T&>(message).serialize(writer) || !writer.flush())
+        return false;
+    out.size = sizeof(message.header) + writer.bytesWritten();
+    return true;
+}
+
+template<typename T>
+bool decode(const uint8_t* data, size_t size, T& message)
+{
+    if (size < sizeof(message.header))
+        return false;
+    std::memcpy(&message.header, data, sizeof(message.header));
+    BitReader reader(data + sizeof(message.header), size - sizeof(message.header));
+    return message.serialize(reader);
+}
+
+} // namespace RType::Network
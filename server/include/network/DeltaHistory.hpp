@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace RType::Network {
+
+// The states a client received for each entity, by snapshot tick, so a
+// field-level delta can be applied to whichever one the server based it
+// on. Each entity keeps its last Depth states; recording a newer one
+// replaces the oldest. Not thread-safe.
+template<typename State, size_t Depth>
+class DeltaHistory {
+public:
+    void record(uint32_t id, uint32_t tick, const State& state)
+    {
+        Ring& ring = _entities[id];
+        ring.slots[ring.next] = Slot{tick, state, true};
+        ring.next = (ring.next + 1) % Depth;
+    }
+
+    // The state id had at tick, or nullptr if it is no longer kept.
+    const State* find(uint32_t id, uint32_t tick) const
+    {
+        auto it = _entities.find(id);
+        if (it == _entities.end())
+            return nullptr;
+        for (const Slot& slot : it->second.slots) {
+            if (slot.valid && slot.tick == tick)
+                return &slot.state;
+        }
+        return nullptr;
+    }
+
+    void erase(uint32_t id) { _entities.erase(id); }
+    void clear() { _entities.clear(); }
+    size_t size() const { return _entities.size(); }
+
+private:
+    struct Slot {
+        uint32_t tick = 0;
+        State state{};
+        bool valid = false;
+    };
+
+    struct Ring {
+        std::array<Slot, Depth> slots{};
+        size_t next = 0;
+    };
+
+    std::unordered_map<uint32_t, Ring> _entities;
+};
+
+} // namespace RType::Network
@@ -0,0 +1,142 @@
+#pragma once
+
+#ifdef _WIN32
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#else
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace RType::Network {
+
+// Peer address as a plain value: a 128-bit IP plus port, both kept in
+// network byte order. IPv4 peers are stored as IPv4-mapped IPv6 addresses
+// (::ffff:a.b.c.d) so both families share one representation, one hash and
+// one comparison. Copying, hashing and comparing never allocate or dispatch.
+class Endpoint {
+public:
+    Endpoint() = default;
+
+    // Accepts dotted IPv4 or textual IPv6. Unparseable input yields the
+    // unspecified address.
+    Endpoint(const std::string& ip, uint16_t port)
+    {
+        in_addr v4{};
+        in6_addr v6{};
+        if (inet_pton(AF_INET, ip.c_str(), &v4) == 1) {
+            setV4(v4.s_addr);
+        } else if (inet_pton(AF_INET6, ip.c_str(), &v6) == 1) {
+            std::memcpy(_ip, &v6, sizeof(_ip));
+        }
+        _port = htons(port);
+    }
+
+    static Endpoint fromNative(const sockaddr_in& addr)
+    {
+        Endpoint endpoint;
+        endpoint.setV4(addr.sin_addr.s_addr);
+        endpoint._port = addr.sin_port;
+        return endpoint;
+    }
+
+    static Endpoint fromNative(const sockaddr_in6& addr)
+    {
+        Endpoint endpoint;
+        std::memcpy(endpoint._ip, &addr.sin6_addr, sizeof(endpoint._ip));
+        endpoint._port = addr.sin6_port;
+        return endpoint;
+    }
+
+    static Endpoint fromNative(const sockaddr_storage& addr)
+    {
+        if (addr.ss_family == AF_INET6)
+            return fromNative(reinterpret_cast<const sockaddr_in6&>(addr));
+        return fromNative(reinterpret_cast<const sockaddr_in&>(addr));
+    }
+
+    // Writes the address in the form a socket of the given family expects
+    // and returns its length, or 0 if this endpoint cannot be reached from
+    // such a socket (an IPv6 peer on an IPv4 socket).
+    size_t toNative(sockaddr_storage& out, int family) const
+    {
+        std::memset(&out, 0, sizeof(out));
+        if (family == AF_INET) {
+            if (!isV4())
+                return 0;
+            auto& addr = reinterpret_cast<sockaddr_in&>(out);
+            addr.sin_family = AF_INET;
+            addr.sin_port = _port;
+            std::memcpy(&addr.sin_addr.s_addr, _ip + 12, 4);
+            return sizeof(sockaddr_in);
+        }
+        auto& addr = reinterpret_cast<sockaddr_in6&>(out);
+        addr.sin6_family = AF_INET6;
+        addr.sin6_port = _port;
+        std::memcpy(&addr.sin6_addr, _ip, sizeof(_ip));
+        return sizeof(sockaddr_in6);
+    }
+
+    bool isV4() const
+    {
+        static constexpr uint8_t prefix[12] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff};
+        return std::memcmp(_ip, prefix, sizeof(prefix)) == 0;
+    }
+
+    uint16_t port() const { return ntohs(_port); }
+
+    std::string toString() const
+    {
+        char text[INET6_ADDRSTRLEN];
+        if (isV4()) {
+            inet_ntop(AF_INET, _ip + 12, text, sizeof(text));
+            return std::string(text) + ":" + std::to_string(port());
+        }
+        inet_ntop(AF_INET6, _ip, text, sizeof(text));
+        return "[" + std::string(text) + "]:" + std::to_string(port());
+    }
+
+    size_t hash() const
+    {
+        uint64_t hi, lo;
+        std::memcpy(&hi, _ip, sizeof(hi));
+        std::memcpy(&lo, _ip + 8, sizeof(lo));
+        uint64_t h = (lo ^ (static_cast<uint64_t>(_port) << 48)) * 0x9E3779B97F4A7C15ULL;
+        h ^= hi + 0x7F4A7C159E3779B9ULL + (h << 6) + (h >> 2);
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+
+    friend bool operator==(const Endpoint& a, const Endpoint& b)
+    {
+        return a._port == b._port && std::memcmp(a._ip, b._ip, sizeof(a._ip)) == 0;
+    }
+
+    friend bool operator!=(const Endpoint& a, const Endpoint& b) { return !(a == b); }
+
+private:
+    void setV4(uint32_t networkOrder)
+    {
+        std::memset(_ip, 0, 10);
+        _ip[10] = 0xff;
+        _ip[11] = 0xff;
+        std::memcpy(_ip + 12, &networkOrder, 4);
+    }
+
+    uint8_t _ip[16] = {};
+    uint16_t _port = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<Endpoint>, "Endpoint must be trivially copyable");
+
+struct EndpointHash {
+    size_t operator()(const Endpoint& endpoint) const { return endpoint.hash(); }
+};
+
+} // namespace RType::Network
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "network/BitStream.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace RType::Network {
+
+// Static Huffman coding of datagram bodies. Both ends build the same code
+// from a shared table of byte frequencies, so nothing about the code
+// travels with the data and every datagram decodes on its own, however
+// the others were lost or reordered. Every byte value gets a code, at most
+// MAX_CODE_LENGTH bits long, and codes are canonical.
+//
+// The compressed form is a varint of the original size followed by the
+// codes, bit-packed like BitWriter. Construction allocates; compress and
+// decompress do not, and are safe to call from any thread.
+class HuffmanCodec {
+public:
+    static constexpr size_t SYMBOLS = 256;
+    static constexpr unsigned MAX_CODE_LENGTH = 15;
+
+    explicit HuffmanCodec(const std::array<uint32_t, SYMBOLS>& frequencies)
+    {
+        // Bytes never seen in training must still be encodable.
+        std::array<uint64_t, SYMBOLS> weights;
+        for (size_t s = 0; s < SYMBOLS; ++s)
+            weights[s] = uint64_t{frequencies[s]} + 1;
+        // Flattening the weights shortens the longest codes until they fit.
+        while (!buildLengths(weights)) {
+            for (auto& weight : weights)
+                weight = (weight >> 1) + 1;
+        }
+        assignCodes();
+    }
+
+    // Returns the compressed size, or 0 when the result would not be
+    // smaller than size or does not fit capacity: compression does not pay
+    // and the caller should send the bytes as they are.
+    size_t compress(const uint8_t* in, size_t size, uint8_t* out, size_t capacity) const
+    {
+        if (size == 0)
+            return 0;
+        BitWriter writer(out, std::min(capacity, size - 1));
+        uint32_t length = static_cast<uint32_t>(size);
+        if (!writer.serializeVarint(length))
+            return 0;
+        for (size_t i = 0; i < size; ++i) {
+            uint32_t code = _codes[in[i]];
+            if (!writer.serializeBits(code, _lengths[in[i]]))
+                return 0;
+        }
+        if (!writer.flush())
+            return 0;
+        return writer.bytesWritten();
+    }
+
+    // Returns the decompressed size, or 0 if in is truncated or would
+    // decompress to more than capacity bytes.
+    size_t decompress(const uint8_t* in, size_t size, uint8_t* out, size_t capacity) const
+    {
+        BitReader reader(in, size);
+        uint32_t length = 0;
+        if (!reader.serializeVarint(length) || length == 0 || length > capacity)
+            return 0;
+        for (uint32_t i = 0; i < length; ++i) {
+            int symbol = decodeSymbol(reader);
+            if (symbol < 0)
+                return 0;
+            out[i] = static_cast<uint8_t>(symbol);
+        }
+        return length;
+    }
+
+    unsigned codeLength(uint8_t symbol) const { return _lengths[symbol]; }
+
+private:
+    bool buildLengths(const std::array<uint64_t, SYMBOLS>& weights)
+    {
+        using Node = std::pair<uint64_t, size_t>;
+        std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+        std::array<size_t, 2 * SYMBOLS - 1> parent{};
+        for (size_t s = 0; s < SYMBOLS; ++s)
+            queue.push({weights[s], s});
+
+        size_t next = SYMBOLS;
+        while (queue.size() > 1) {
+            Node a = queue.top();
+            queue.pop();
+            Node b = queue.top();
+            queue.pop();
+            parent[a.second] = next;
+            parent[b.second] = next;
+            queue.push({a.first + b.first, next++});
+        }
+
+        size_t root = next - 1;
+        for (size_t s = 0; s < SYMBOLS; ++s) {
+            unsigned length = 0;
+            for (size_t node = s; node != root; node = parent[node])
+                ++length;
+            if (length > MAX_CODE_LENGTH)
+                return false;
+            _lengths[s] = length;
+        }
+        return true;
+    }
+
+    // Canonical codes: by length, then by byte value. Stored bit-reversed
+    // so BitWriter, which packs least significant first, emits them most
+    // significant bit first, the order decodeSymbol() reads them in.
+    void assignCodes()
+    {
+        _counts.fill(0);
+        for (size_t s = 0; s < SYMBOLS; ++s)
+            ++_counts[_lengths[s]];
+
+        size_t index = 0;
+        for (unsigned length = 1; length <= MAX_CODE_LENGTH; ++length) {
+            for (size_t s = 0; s < SYMBOLS; ++s) {
+                if (_lengths[s] == length)
+                    _sorted[index++] = static_cast<uint8_t>(s);
+            }
+        }
+
+        uint32_t code = 0;
+        unsigned previous = _lengths[_sorted[0]];
+        for (uint8_t symbol : _sorted) {
+            code <<= _lengths[symbol] - previous;
+            previous = _lengths[symbol];
+            uint32_t reversed = 0;
+            for (unsigned bit = 0; bit < previous; ++bit)
+                reversed |= ((code >> bit) & 1u) << (previous - 1 - bit);
+            _codes[symbol] = reversed;
+            ++code;
+        }
+    }
+
+    int decodeSymbol(BitReader& reader) const
+    {
+        uint32_t code = 0;
+        uint32_t first = 0;
+        uint32_t index = 0;
+        for (unsigned length = 1; length <= MAX_CODE_LENGTH; ++length) {
+            uint32_t bit = 0;
+            if (!reader.serializeBits(bit, 1))
+                return -1;
+            code |= bit;
+            uint32_t count = _counts[length];
+            if (code < first + count)
+                return _sorted[index + code - first];
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+
+    std::array<unsigned, SYMBOLS> _lengths{};
+    std::array<uint32_t, SYMBOLS> _codes{};
+    std::array<uint32_t, MAX_CODE_LENGTH + 1> _counts{};
+    std::array<uint8_t, SYMBOLS> _sorted{};
+};
+
+} // namespace RType::Network
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "network/Endpoint.hpp"
 #include <cstddef>
 #include <cstdint>
 #include <string>
@@ -11,13 +12,17 @@
 
 namespace RType::Network {
 
-class IAddress {
-public:
-    virtual ~IAddress() = default;
-    virtual std::string toString() const = 0;
-    virtual bool equals(const IAddress& other) const = 0;
-    virtual std::unique_ptr<IAddress> clone() const = 0;
-    virtual size_t hash() const = 0;
+struct OutgoingDatagram {
+    const void* data;
+    size_t size;
+    Endpoint dest;
+};
+
+struct ReceiveSlot {
+    void* buffer;
+    size_t capacity;
+    size_t size;
+    Endpoint source;
 };
 
 class ISocket {
@@ -28,8 +33,34 @@ public:
     virtual void setNonBlocking(bool nonBlocking) = 0;
     virtual void close() = 0;
     
-    virtual ssize_t sendTo(const void* data, size_t size, const IAddress& dest) = 0;
-    virtual ssize_t receiveFrom(void* buffer, size_t size, IAddress& source) = 0;
+    virtual ssize_t sendTo(const void* data, size_t size, const Endpoint& dest) = 0;
+    virtual ssize_t receiveFrom(void* buffer, size_t size, Endpoint& source) = 0;
+
+    // Batch variants. Sockets that cannot batch fall back to one call per
+    // datagram. sendBatch returns how many datagrams were handed to the
+    // kernel; receiveBatch fills slots in order (setting size) and returns
+    // how many were received without blocking.
+    virtual size_t sendBatch(const OutgoingDatagram* packets, size_t count) {
+        size_t sent = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (sendTo(packets[i].data, packets[i].size, packets[i].dest) >= 0)
+                ++sent;
+        }
+        return sent;
+    }
+
+    virtual size_t receiveBatch(ReceiveSlot* slots, size_t count) {
+        size_t received = 0;
+        while (received < count) {
+            ReceiveSlot& slot = slots[received];
+            ssize_t bytes = receiveFrom(slot.buffer, slot.capacity, slot.source);
+            if (bytes < 0)
+                break;
+            slot.size = static_cast<size_t>(bytes);
+            ++received;
+        }
+        return received;
+    }
     
     virtual int getFd() const = 0;
     virtual uint16_t getPort() const = 0;
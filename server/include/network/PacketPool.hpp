@@ -0,0 +1,174 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace RType::Network {
+
+class PacketPool;
+
+namespace Detail {
+
+struct PacketSlab {
+    std::atomic<uint32_t> refs{0};
+    PacketPool* owner = nullptr;
+    uint8_t* bytes = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+};
+
+} // namespace Detail
+
+// Ref-counted handle to a packet slab. Copies share the slab; the last
+// handle returns it to its pool. Handles created with assign() outside a
+// pool own a standalone heap slab (for synthesized messages, not the
+// receive path).
+class PacketBuffer {
+public:
+    PacketBuffer() = default;
+    ~PacketBuffer() { release(); }
+
+    PacketBuffer(const PacketBuffer& other)
+        : _slab(other._slab)
+    {
+        if (_slab)
+            _slab->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    PacketBuffer(PacketBuffer&& other) noexcept
+        : _slab(other._slab)
+    {
+        other._slab = nullptr;
+    }
+
+    PacketBuffer& operator=(PacketBuffer other) noexcept
+    {
+        std::swap(_slab, other._slab);
+        return *this;
+    }
+
+    uint8_t* data() { return _slab ? _slab->bytes : nullptr; }
+    const uint8_t* data() const { return _slab ? _slab->bytes : nullptr; }
+    size_t size() const { return _slab ? _slab->size : 0; }
+    size_t capacity() const { return _slab ? _slab->capacity : 0; }
+    bool empty() const { return size() == 0; }
+    explicit operator bool() const { return _slab != nullptr; }
+
+    // Size is clamped to the slab capacity.
+    void resize(size_t size)
+    {
+        if (_slab)
+            _slab->size = size < _slab->capacity ? size : _slab->capacity;
+    }
+
+    // Copies [first, last) into a fresh standalone slab.
+    void assign(const uint8_t* first, const uint8_t* last)
+    {
+        size_t size = static_cast<size_t>(last - first);
+        auto* slab = new Detail::PacketSlab;
+        slab->refs.store(1, std::memory_order_relaxed);
+        slab->bytes = new uint8_t[size > 0 ? size : 1];
+        slab->size = size;
+        slab->capacity = size;
+        if (size > 0)
+            std::memcpy(slab->bytes, first, size);
+
+        release();
+        _slab = slab;
+    }
+
+private:
+    friend class PacketPool;
+
+    explicit PacketBuffer(Detail::PacketSlab* slab)
+        : _slab(slab)
+    {
+    }
+
+    inline void release();
+
+    Detail::PacketSlab* _slab = nullptr;
+};
+
+// Fixed set of equally sized slabs carved out of one allocation up front.
+// acquire() and the final release of a handle never touch the heap. The
+// pool must outlive every buffer it hands out.
+class PacketPool {
+public:
+    PacketPool(size_t slabCount, size_t slabSize)
+        : _storage(std::make_unique<uint8_t[]>(slabCount * slabSize))
+        , _slabs(slabCount)
+    {
+        _free.reserve(slabCount);
+        for (size_t i = 0; i < slabCount; ++i) {
+            _slabs[i].owner = this;
+            _slabs[i].bytes = _storage.get() + i * slabSize;
+            _slabs[i].capacity = slabSize;
+            _free.push_back(&_slabs[i]);
+        }
+    }
+
+    PacketPool(const PacketPool&) = delete;
+    PacketPool& operator=(const PacketPool&) = delete;
+
+    // Returns an empty handle when every slab is in use.
+    PacketBuffer acquire()
+    {
+        Detail::PacketSlab* slab;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_free.empty())
+                return PacketBuffer();
+            slab = _free.back();
+            _free.pop_back();
+        }
+        slab->refs.store(1, std::memory_order_relaxed);
+        slab->size = slab->capacity;
+        return PacketBuffer(slab);
+    }
+
+    size_t available() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _free.size();
+    }
+
+    size_t capacity() const { return _slabs.size(); }
+
+private:
+    friend class PacketBuffer;
+
+    void recycle(Detail::PacketSlab* slab)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _free.push_back(slab);
+    }
+
+    std::unique_ptr<uint8_t[]> _storage;
+    std::vector<Detail::PacketSlab> _slabs;
+    std::vector<Detail::PacketSlab*> _free;
+    mutable std::mutex _mutex;
+};
+
+inline void PacketBuffer::release()
+{
+    if (!_slab)
+        return;
+    if (_slab->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (_slab->owner) {
+            _slab->owner->recycle(_slab);
+        } else {
+            delete[] _slab->bytes;
+            delete _slab;
+        }
+    }
+    _slab = nullptr;
+}
+
+} // namespace RType::Network
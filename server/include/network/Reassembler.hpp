@@ -0,0 +1,163 @@
+#pragma once
+
+#include "network/Endpoint.hpp"
+#include <bitset>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace RType::Network {
+
+// Rebuilds messages that were split into fragments (see
+// Protocol::FragmentHeader). At most MAX_PARTIALS messages are in progress
+// at once, each up to MAX_MESSAGE_SIZE bytes; a message that is not
+// complete within TIMEOUT is dropped, and when every slot is busy the
+// oldest partial message makes room for a new one. Slot buffers keep their
+// capacity, so steady-state reassembly does not allocate. Not thread-safe.
+class Reassembler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t MAX_PARTIALS = 32;
+    static constexpr size_t MAX_MESSAGE_SIZE = 64 * 1024;
+    static constexpr size_t MAX_FRAGMENTS = 255;
+    static constexpr auto TIMEOUT = std::chrono::milliseconds(1000);
+
+    struct Fragment {
+        uint16_t message_id;
+        uint8_t index;
+        uint8_t count;
+        uint32_t total_size;
+        uint32_t offset;
+        const uint8_t* data;
+        size_t size;
+    };
+
+    // Returns the whole message once fragment completes it, or nullptr.
+    // The returned buffer stays valid until the next call.
+    const std::vector<uint8_t>* add(const Endpoint& from, const Fragment& fragment,
+                                    Clock::time_point now)
+    {
+        if (fragment.count == 0 || fragment.index >= fragment.count
+            || fragment.total_size == 0 || fragment.total_size > MAX_MESSAGE_SIZE
+            || fragment.offset > fragment.total_size
+            || fragment.size > fragment.total_size - fragment.offset) {
+            ++_dropped;
+            return nullptr;
+        }
+
+        expire(now);
+
+        Partial* partial = find(from, fragment.message_id);
+        if (partial && (partial->count != fragment.count
+                        || partial->bytes.size() != fragment.total_size)) {
+            // Same id reused for a different message: start over.
+            release(*partial);
+            ++_dropped;
+            partial = nullptr;
+        }
+        if (!partial) {
+            partial = claim();
+            partial->in_use = true;
+            partial->from = from;
+            partial->message_id = fragment.message_id;
+            partial->count = fragment.count;
+            partial->received = 0;
+            partial->bytes_received = 0;
+            partial->have.reset();
+            partial->bytes.resize(fragment.total_size);
+            partial->started = now;
+        }
+
+        if (partial->have.test(fragment.index))
+            return nullptr;
+        partial->have.set(fragment.index);
+        ++partial->received;
+        partial->bytes_received += fragment.size;
+        std::memcpy(partial->bytes.data() + fragment.offset, fragment.data, fragment.size);
+
+        if (partial->received < partial->count)
+            return nullptr;
+
+        release(*partial);
+        if (partial->bytes_received != partial->bytes.size()) {
+            ++_dropped;
+            return nullptr;
+        }
+        _complete.swap(partial->bytes);
+        return &_complete;
+    }
+
+    // Drops partial messages older than TIMEOUT.
+    void expire(Clock::time_point now)
+    {
+        for (Partial& partial : _partials) {
+            if (partial.in_use && now - partial.started >= TIMEOUT) {
+                release(partial);
+                ++_dropped;
+            }
+        }
+    }
+
+    size_t pending() const
+    {
+        size_t count = 0;
+        for (const Partial& partial : _partials)
+            count += partial.in_use ? 1 : 0;
+        return count;
+    }
+
+    // Messages given up on (timed out, evicted or malformed), for metrics.
+    uint64_t takeDropped()
+    {
+        uint64_t dropped = _dropped;
+        _dropped = 0;
+        return dropped;
+    }
+
+private:
+    struct Partial {
+        bool in_use = false;
+        Endpoint from;
+        uint16_t message_id = 0;
+        uint8_t count = 0;
+        uint8_t received = 0;
+        size_t bytes_received = 0;
+        std::bitset<MAX_FRAGMENTS> have;
+        std::vector<uint8_t> bytes;
+        Clock::time_point started;
+    };
+
+    Partial* find(const Endpoint& from, uint16_t messageId)
+    {
+        for (Partial& partial : _partials) {
+            if (partial.in_use && partial.message_id == messageId && partial.from == from)
+                return &partial;
+        }
+        return nullptr;
+    }
+
+    Partial* claim()
+    {
+        Partial* oldest = nullptr;
+        for (Partial& partial : _partials) {
+            if (!partial.in_use)
+                return &partial;
+            if (!oldest || partial.started < oldest->started)
+                oldest = &partial;
+        }
+        release(*oldest);
+        ++_dropped;
+        return oldest;
+    }
+
+    static void release(Partial& partial) { partial.in_use = false; }
+
+    Partial _partials[MAX_PARTIALS];
+    std::vector<uint8_t> _complete;
+    uint64_t _dropped = 0;
+};
+
+} // namespace RType::Network
@@ -0,0 +1,226 @@
+#pragma once
+
+#include "core/TimerWheel.hpp"
+#include "network/ReliableUDP.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace RType::Network {
+
+struct PendingReliablePacket {
+    std::vector<uint8_t> data;
+    std::chrono::steady_clock::time_point last_sent;
+    std::chrono::steady_clock::time_point deadline;
+    uint8_t retries = 0;
+    Core::TimerWheel::Handle timer = Core::TimerWheel::INVALID_HANDLE;
+};
+
+// Reliable sequence numbers seen from one peer: the newest one plus a
+// SIZE-bit bitmap, indexed by sequence modulo SIZE, of those in the SIZE
+// sequences up to it. Sequences are compared modulo 2^16, so the window
+// slides across wrap-around. Anything older than the window is reported as
+// already seen: without its bit there is no way to tell, and handling a
+// packet twice is worse than dropping a straggler the peer has long
+// stopped retransmitting. Fixed size, no allocation.
+struct SequenceWindow {
+    static constexpr uint16_t SIZE = 256;
+
+    bool contains(uint16_t sequence) const {
+        if (!valid)
+            return false;
+        auto age = static_cast<int16_t>(newest - sequence);
+        if (age < 0)
+            return false;
+        if (age >= SIZE)
+            return true;
+        return test(sequence);
+    }
+
+    void insert(uint16_t sequence) {
+        if (!valid) {
+            valid = true;
+            newest = sequence;
+            bits = {};
+            set(sequence);
+            return;
+        }
+
+        auto ahead = static_cast<int16_t>(sequence - newest);
+        if (ahead > 0) {
+            // Slots between the old newest and this one now stand for
+            // sequences not seen yet.
+            if (ahead >= SIZE) {
+                bits = {};
+            } else {
+                for (uint16_t s = newest + 1; s != sequence; ++s)
+                    clear(s);
+            }
+            newest = sequence;
+        } else if (-ahead >= SIZE) {
+            return;
+        }
+        set(sequence);
+    }
+
+    bool valid = false;
+    uint16_t newest = 0;
+    std::array<uint64_t, SIZE / 64> bits{};
+
+private:
+    bool test(uint16_t sequence) const {
+        uint16_t slot = sequence % SIZE;
+        return (bits[slot / 64] >> (slot % 64)) & 1u;
+    }
+    void set(uint16_t sequence) {
+        uint16_t slot = sequence % SIZE;
+        bits[slot / 64] |= uint64_t{1} << (slot % 64);
+    }
+    void clear(uint16_t sequence) {
+        uint16_t slot = sequence % SIZE;
+        bits[slot / 64] &= ~(uint64_t{1} << (slot % 64));
+    }
+};
+
+// Acknowledgement state for the reliable sequences received from one peer,
+// in the form PacketHeader::setAcks() carries it back: the newest sequence
+// plus one bit for each of the SPAN sequences before it.
+struct AckWindow {
+    static constexpr uint16_t SPAN = 32;
+    // How long an ack may wait for outgoing traffic to ride on before it
+    // is sent on its own.
+    static constexpr auto FLUSH_DELAY = std::chrono::milliseconds(20);
+
+    // Returns false if sequence is too old for the window; it then has to
+    // be acknowledged explicitly.
+    bool record(uint16_t sequence) {
+        if (!valid) {
+            valid = true;
+            ack = sequence;
+            bits = 0;
+            return true;
+        }
+
+        auto distance = static_cast<int16_t>(sequence - ack);
+        if (distance > 0) {
+            if (distance > SPAN)
+                bits = 0;
+            else if (distance == SPAN)
+                bits = 1u << (SPAN - 1);
+            else
+                bits = (bits << distance) | (1u << (distance - 1));
+            ack = sequence;
+            return true;
+        }
+        if (distance == 0)
+            return true;
+        if (-distance > SPAN)
+            return false;
+        bits |= 1u << (-distance - 1);
+        return true;
+    }
+
+    bool valid = false;
+    uint16_t ack = 0;
+    uint32_t bits = 0;
+};
+
+// Calls onAcked for every sequence a received (ack, ack_bits) pair covers.
+template<typename F>
+void forEachAcked(uint16_t ack, uint32_t bits, F&& onAcked)
+{
+    onAcked(ack);
+    for (uint16_t n = 0; n < AckWindow::SPAN; ++n) {
+        if (bits & (1u << n))
+            onAcked(static_cast<uint16_t>(ack - 1 - n));
+    }
+}
+
+// Round-trip estimate for one peer, after RFC 6298: SRTT and RTTVAR are
+// smoothed with gains 1/8 and 1/4 and RTO = SRTT + max(G, 4 * RTTVAR).
+// The peer may sit on an ack for up to AckWindow::FLUSH_DELAY, so that is
+// added on top. A timeout doubles the RTO until the next sample, once per
+// RTO: packets in flight together time out together, and a burst of them
+// is one loss event, not one per packet.
+struct RttEstimator {
+    using Duration = std::chrono::microseconds;
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    static constexpr Duration INITIAL_RTO = std::chrono::milliseconds(100);
+    static constexpr Duration MIN_RTO = std::chrono::milliseconds(25);
+    static constexpr Duration MAX_RTO = std::chrono::seconds(2);
+    static constexpr Duration GRANULARITY = std::chrono::milliseconds(1);
+
+    void sample(Duration rtt) {
+        if (!valid) {
+            valid = true;
+            srtt = rtt;
+            rttvar = rtt / 2;
+        } else {
+            Duration error = srtt > rtt ? srtt - rtt : rtt - srtt;
+            rttvar = (rttvar * 3 + error) / 4;
+            srtt = (srtt * 7 + rtt) / 8;
+        }
+        rto = std::clamp<Duration>(srtt + std::max<Duration>(GRANULARITY, rttvar * 4)
+                                       + AckWindow::FLUSH_DELAY,
+                                   MIN_RTO, MAX_RTO);
+        backed_off = false;
+    }
+
+    // Timeouts within one (backed-off) RTO of the last backoff are part of
+    // the same loss event and leave the RTO alone.
+    void backoff(TimePoint now) {
+        if (backed_off && now - last_backoff < rto)
+            return;
+        rto = std::min<Duration>(rto * 2, MAX_RTO);
+        backed_off = true;
+        last_backoff = now;
+    }
+
+    bool valid = false;
+    Duration srtt{0};
+    Duration rttvar{0};
+    Duration rto = INITIAL_RTO;
+    bool backed_off = false;
+    TimePoint last_backoff;
+};
+
+// Reliability state for one peer. Each peer numbers its reliable packets
+// in its own 16-bit sequence space, so a broadcast leaves one pending copy
+// per recipient and an ACK only ever settles the sender's own copy.
+//
+// ordered numbers the messages sent on the peer's ordered channel; they
+// travel as ordinary reliable packets.
+//
+// Acks for the peer's reliable packets ride in the header of whatever goes
+// back to it next; ack_pending marks acks that have not left yet. rtt is
+// fed by acks of packets sent once (Karn's rule) and by ping replies.
+//
+// The channel does no locking: the owner guards the send side (sequence,
+// pending, rtt, ordered and the ping fields) and the receive side (received, acks,
+// ack_pending) with its own mutexes.
+struct ReliableChannel {
+    uint16_t nextSequence() {
+        uint16_t sequence = next_send_sequence++;
+        if (next_send_sequence == 0)
+            next_send_sequence = 1;
+        return sequence;
+    }
+
+    uint16_t next_send_sequence = 1;
+    std::unordered_map<uint16_t, PendingReliablePacket> pending;
+    RttEstimator rtt;
+    ReliableUDP ordered;
+    uint16_t ping_sequence = 0;
+    bool ping_outstanding = false;
+    std::chrono::steady_clock::time_point ping_sent;
+    SequenceWindow received;
+    AckWindow acks;
+    bool ack_pending = false;
+};
+
+} // namespace RType::Network
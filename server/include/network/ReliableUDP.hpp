@@ -1,76 +1,117 @@
 #pragma once
 
-#include "network/ISocket.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <vector>
-#include <chrono>
-#include <functional>
-#include <thread>
-#include <atomic>
-#include <mutex>
 
 namespace RType::Network {
 
+// Ordered delivery for one peer, multiplexed over the same socket as
+// everything else. The sender numbers each ordered message in its own
+// 16-bit sequence space (Protocol::OrderedHeader) and sends it reliably,
+// so every message eventually arrives; the receiver holds back the ones
+// that arrive after a gap and releases them in order once it is filled.
+//
+// A gap the sender gave up on (after its retries ran out) would stall the
+// stream forever, so it is skipped once MAX_BUFFERED messages wait behind
+// it or the oldest has waited GAP_TIMEOUT. Both are checked on arrival;
+// the timeout is also checked by poll(), which the owner calls on a timer
+// so that the last messages before a quiet spell are not held forever.
+// Not thread-safe.
 class ReliableUDP {
 public:
-    using PacketCallback = std::function<void(const std::vector<uint8_t>&)>;
-    
-    explicit ReliableUDP(std::unique_ptr<ISocket> socket);
-    ~ReliableUDP();
-    
-    void start();
-    void stop();
-    
-    void sendReliable(const void* data, size_t size, const IAddress& dest);
-    
-    void sendUnreliable(const void* data, size_t size, const IAddress& dest);
-    
-    void setPacketCallback(PacketCallback callback);
-    
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t MAX_BUFFERED = 64;
+    static constexpr auto GAP_TIMEOUT = std::chrono::seconds(5);
+
+    uint16_t nextSendSequence() { return _nextSendSeq++; }
+
+    // Calls deliver(data, size) for this message and for every held-back
+    // message it unblocks, in sequence order. Duplicates are dropped.
+    template<typename F>
+    void receive(uint16_t sequence, const uint8_t* data, size_t size,
+                 Clock::time_point now, F&& deliver)
+    {
+        auto distance = static_cast<int16_t>(sequence - _nextRecvSeq);
+        if (distance < 0)
+            return;
+
+        if (distance > 0) {
+            if (_recvBuffer.empty())
+                _gapSince = now;
+            _recvBuffer.try_emplace(sequence, data, data + size);
+            if (_recvBuffer.size() >= MAX_BUFFERED || now - _gapSince >= GAP_TIMEOUT) {
+                skipGap(deliver);
+                _gapSince = now;
+            }
+            return;
+        }
+
+        // Advance before delivering, so a handler that re-enters sees a
+        // consistent state.
+        ++_nextRecvSeq;
+        deliver(data, size);
+        drain(deliver);
+        if (!_recvBuffer.empty())
+            _gapSince = now;
+    }
+
+    // Skips a gap that has waited GAP_TIMEOUT, delivering what was held
+    // behind it, even though nothing new arrived.
+    template<typename F>
+    void poll(Clock::time_point now, F&& deliver)
+    {
+        if (_recvBuffer.empty() || now - _gapSince < GAP_TIMEOUT)
+            return;
+        skipGap(deliver);
+        _gapSince = now;
+    }
+
+    // When poll() will next have something to do, or Clock::time_point::max().
+    Clock::time_point gapDeadline() const
+    {
+        return _recvBuffer.empty() ? Clock::time_point::max() : _gapSince + GAP_TIMEOUT;
+    }
+
+    size_t buffered() const { return _recvBuffer.size(); }
+    uint16_t expectedSequence() const { return _nextRecvSeq; }
+
 private:
-    struct PendingPacket {
-        std::vector<uint8_t> data;
-        std::shared_ptr<IAddress> dest;
-        std::chrono::steady_clock::time_point sent_time;
-        uint32_t sequence;
-        uint8_t retries;
-        bool acked;
-    };
-    
-    struct ReliableHeader {
-        uint32_t magic;
-        uint32_t sequence;
-        uint8_t is_ack;
-        uint8_t padding[3];
-    } __attribute__((packed));
-    
-    void receiveLoop();
-    void retryLoop();
-    void processReceivedPacket(const std::vector<uint8_t>& data,
-                               const std::shared_ptr<IAddress>& from);
-    void sendAck(uint32_t sequence, const IAddress& dest);
-    void handleAck(uint32_t sequence);
-    
-    std::unique_ptr<ISocket> _socket;
-    PacketCallback _callback;
-    
-    std::atomic<uint32_t> _nextSendSeq;
-    
-    uint32_t _nextRecvSeq;
-    std::mutex _recvMutex;
-    
-    std::map<uint32_t, std::vector<uint8_t>> _recvBuffer;
-    
-    std::map<uint32_t, PendingPacket> _pendingAcks;
-    std::mutex _pendingMutex;
-    
-    std::thread _receiveThread;
-    std::thread _retryThread;
-    std::atomic<bool> _running;
-    
-    static constexpr auto RETRY_TIMEOUT = std::chrono::milliseconds(100);
-    static constexpr uint8_t MAX_RETRIES = 5;
-    static constexpr uint32_t MAGIC = 0x52454C55;
+    template<typename F>
+    void drain(F&& deliver)
+    {
+        for (auto it = _recvBuffer.find(_nextRecvSeq); it != _recvBuffer.end();
+             it = _recvBuffer.find(_nextRecvSeq)) {
+            std::vector<uint8_t> message = std::move(it->second);
+            _recvBuffer.erase(it);
+            ++_nextRecvSeq;
+            deliver(message.data(), message.size());
+        }
+    }
+
+    // Jumps to the oldest held-back message and releases from there. The
+    // map's numeric order is wrong across the 16-bit wrap, so oldest means
+    // nearest ahead of the expected sequence.
+    template<typename F>
+    void skipGap(F&& deliver)
+    {
+        uint16_t oldest = _recvBuffer.begin()->first;
+        for (const auto& [sequence, message] : _recvBuffer) {
+            if (static_cast<uint16_t>(sequence - _nextRecvSeq) < static_cast<uint16_t>(oldest - _nextRecvSeq))
+                oldest = sequence;
+        }
+        _nextRecvSeq = oldest;
+        drain(deliver);
+    }
+
+    uint16_t _nextSendSeq = 0;
+    uint16_t _nextRecvSeq = 0;
+    // Keyed by sequence; looked up exactly, so wrap-around is harmless.
+    std::map<uint16_t, std::vector<uint8_t>> _recvBuffer;
+    Clock::time_point _gapSince;
 };
 
-} // namespace RType::Network
\ No newline at end of file
+} // namespace RType::Network
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "network/BitStream.hpp"
+#include "network/HuffmanCodec.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace RType::Network {
+
+// Byte frequencies of ENTITY_UPDATE bodies (everything after the header),
+// recorded from r-type_loadgen --train with 4 players per room. The server
+// and every client build their snapshot codec from this table, so changing
+// it changes the wire format.
+inline constexpr std::array<uint32_t, HuffmanCodec::SYMBOLS> SNAPSHOT_BYTE_FREQUENCIES = {
+    83355, 78006, 27760, 4276, 139449, 2898, 11254, 8327, 33467, 31599, 26625, 3080, 4405, 3092, 5294, 3189,
+    148357, 2809, 6970, 3934, 5718, 4164, 5068, 4257, 8424, 6744, 6546, 4354, 4716, 4159, 4516, 8610,
+    18407, 11507, 21596, 18968, 10195, 8620, 20233, 16890, 12471, 8114, 17818, 12634, 5302, 3288, 6216, 7671,
+    9579, 3313, 5232, 3472, 4408, 3254, 5823, 3477, 9891, 5873, 5875, 4096, 4569, 3034, 5817, 4446,
+    38061, 78455, 65144, 5420, 3176, 3497, 4590, 3339, 14323, 9982, 5123, 3606, 3320, 4566, 4672, 3602,
+    9513, 2664, 4612, 3239, 3768, 3526, 4711, 3439, 8730, 4938, 5754, 3019, 4354, 3820, 4659, 3400,
+    12325, 8235, 12695, 6811, 20760, 6093, 6542, 4252, 9540, 5990, 6903, 3559, 5333, 4203, 4820, 2877,
+    8303, 3693, 5654, 2488, 4444, 2770, 5683, 4202, 7328, 5520, 5899, 2902, 4640, 3381, 5798, 6553,
+    32060, 5894, 7922, 5061, 7936, 6748, 11651, 8899, 15572, 13189, 12743, 12837, 10467, 7984, 9746, 9761,
+    11911, 6128, 8625, 6467, 7930, 5904, 8027, 5335, 12998, 9711, 9159, 7225, 8733, 6868, 8456, 7148,
+    16706, 9609, 11405, 8391, 8923, 7615, 7735, 5951, 12527, 9836, 9595, 7059, 7440, 6790, 8255, 5255,
+    8955, 3693, 5638, 3450, 4488, 5092, 4345, 2894, 8444, 4832, 5611, 2954, 3766, 7026, 4285, 3241,
+    29723, 2015, 6749, 2007, 4251, 2352, 4377, 1870, 8049, 4990, 6088, 2260, 3556, 1939, 4087, 1994,
+    11702, 2304, 4040, 2026, 3283, 1766, 5573, 2804, 7575, 5269, 4822, 3233, 2929, 2654, 4513, 3086,
+    11727, 11117, 13697, 7691, 6813, 5916, 5390, 3670, 9641, 6038, 5103, 3874, 3761, 2370, 4379, 2178,
+    10969, 2327, 4770, 2072, 7367, 2075, 4364, 3063, 7965, 4895, 7530, 2878, 5006, 3323, 5053, 3694,
+};
+
+inline const HuffmanCodec& snapshotCodec()
+{
+    static const HuffmanCodec codec(SNAPSHOT_BYTE_FREQUENCIES);
+    return codec;
+}
+
+// Copies the first headerSize bytes of in and compresses the rest into
+// out. Returns the compressed body size, or 0 if compression does not pay
+// and in should go out as it is.
+template<size_t Capacity>
+size_t compressBody(const EncodedPacket<Capacity>& in, size_t headerSize, EncodedPacket<Capacity>& out)
+{
+    if (in.size <= headerSize)
+        return 0;
+    size_t body = snapshotCodec().compress(in.bytes + headerSize, in.size - headerSize,
+                                           out.bytes + headerSize, Capacity - headerSize);
+    if (body == 0)
+        return 0;
+    std::memcpy(out.bytes, in.bytes, headerSize);
+    out.size = headerSize + body;
+    return body;
+}
+
+// The reverse, for a received datagram: out gets the header as-is and the
+// decompressed body. Returns false if the body is malformed or too large.
+template<size_t Capacity>
+bool decompressBody(const uint8_t* data, size_t size, size_t headerSize, EncodedPacket<Capacity>& out)
+{
+    if (size <= headerSize || headerSize >= Capacity)
+        return false;
+    size_t body = snapshotCodec().decompress(data + headerSize, size - headerSize,
+                                             out.bytes + headerSize, Capacity - headerSize);
+    if (body == 0)
+        return false;
+    std::memcpy(out.bytes, data, headerSize);
+    out.size = headerSize + body;
+    return true;
+}
+
+} // namespace RType::Network
@@ -0,0 +1,154 @@
+#pragma once
+
+#ifdef _WIN32
+    #include <winsock2.h>
+#elif defined(__linux__)
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <unistd.h>
+#else
+    #include <poll.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+
+namespace RType::Network {
+
+// Blocks a receive thread until its socket is readable instead of spinning
+// on a nonblocking socket. wake() interrupts a pending wait() from any
+// thread, which is how shutdown reaches a thread blocked with no traffic.
+//
+// Linux uses epoll plus an eventfd, other POSIX systems poll() plus a
+// self-pipe. Windows has no portable wakeup handle for WSAPoll, so waits
+// are capped at WINDOWS_WAKE_INTERVAL_MS and wake() is a no-op.
+class SocketWaiter {
+public:
+    explicit SocketWaiter(int fd)
+        : _fd(fd)
+    {
+#if defined(__linux__)
+        _epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        _wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_epollFd < 0 || _wakeFd < 0) {
+            closeAll();
+            throw std::runtime_error("Failed to create socket waiter");
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = _fd;
+        if (::epoll_ctl(_epollFd, EPOLL_CTL_ADD, _fd, &event) < 0) {
+            closeAll();
+            throw std::runtime_error("Failed to watch socket");
+        }
+        event.data.fd = _wakeFd;
+        if (::epoll_ctl(_epollFd, EPOLL_CTL_ADD, _wakeFd, &event) < 0) {
+            closeAll();
+            throw std::runtime_error("Failed to watch wakeup handle");
+        }
+#elif !defined(_WIN32)
+        if (::pipe(_pipe) < 0) {
+            throw std::runtime_error("Failed to create socket waiter");
+        }
+        for (int end : _pipe) {
+            ::fcntl(end, F_SETFL, ::fcntl(end, F_GETFL, 0) | O_NONBLOCK);
+            ::fcntl(end, F_SETFD, FD_CLOEXEC);
+        }
+#endif
+    }
+
+    ~SocketWaiter() { closeAll(); }
+
+    SocketWaiter(const SocketWaiter&) = delete;
+    SocketWaiter& operator=(const SocketWaiter&) = delete;
+
+    // Returns true when the socket has data. A negative timeout waits until
+    // data arrives or wake() is called.
+    bool wait(std::chrono::milliseconds timeout)
+    {
+        int timeoutMs = timeout.count() < 0 ? -1 : static_cast<int>(timeout.count());
+
+#if defined(__linux__)
+        epoll_event events[2];
+        int count = ::epoll_wait(_epollFd, events, 2, timeoutMs);
+        bool readable = false;
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.fd == _wakeFd) {
+                uint64_t value;
+                (void)!::read(_wakeFd, &value, sizeof(value));
+            } else {
+                readable = true;
+            }
+        }
+        return readable;
+#elif defined(_WIN32)
+        if (timeoutMs < 0 || timeoutMs > WINDOWS_WAKE_INTERVAL_MS) {
+            timeoutMs = WINDOWS_WAKE_INTERVAL_MS;
+        }
+        WSAPOLLFD pfd{};
+        pfd.fd = static_cast<SOCKET>(_fd);
+        pfd.events = POLLRDNORM;
+        return ::WSAPoll(&pfd, 1, timeoutMs) > 0 && (pfd.revents & POLLRDNORM);
+#else
+        pollfd fds[2] = {{_fd, POLLIN, 0}, {_pipe[0], POLLIN, 0}};
+        if (::poll(fds, 2, timeoutMs) <= 0) {
+            return false;
+        }
+        if (fds[1].revents & POLLIN) {
+            char drain[64];
+            while (::read(_pipe[0], drain, sizeof(drain)) > 0) {
+            }
+        }
+        return (fds[0].revents & POLLIN) != 0;
+#endif
+    }
+
+    void wake()
+    {
+#if defined(__linux__)
+        uint64_t one = 1;
+        (void)!::write(_wakeFd, &one, sizeof(one));
+#elif !defined(_WIN32)
+        char byte = 1;
+        (void)!::write(_pipe[1], &byte, 1);
+#endif
+    }
+
+private:
+    void closeAll()
+    {
+#if defined(__linux__)
+        if (_wakeFd >= 0) {
+            ::close(_wakeFd);
+            _wakeFd = -1;
+        }
+        if (_epollFd >= 0) {
+            ::close(_epollFd);
+            _epollFd = -1;
+        }
+#elif !defined(_WIN32)
+        for (int& end : _pipe) {
+            if (end >= 0) {
+                ::close(end);
+                end = -1;
+            }
+        }
+#endif
+    }
+
+    int _fd;
+#if defined(__linux__)
+    int _epollFd = -1;
+    int _wakeFd = -1;
+#elif defined(_WIN32)
+    static constexpr int WINDOWS_WAKE_INTERVAL_MS = 50;
+#else
+    int _pipe[2] = {-1, -1};
+#endif
+};
+
+} // namespace RType::Network
@@ -1,7 +1,6 @@
 #pragma once
 
 #include "network/ISocket.hpp"
-#include "network/UDPAddress.hpp"
 
 #ifdef _WIN32
     #define NOMINMAX
@@ -12,10 +11,13 @@
     typedef int ssize_t;
 #else
     #include <sys/socket.h>
+    #include <sys/uio.h>
     #include <unistd.h>
     #include <fcntl.h>
+    #include <cerrno>
 #endif
 
+#include <algorithm>
 #include <stdexcept>
 #include <cstring>
 
@@ -23,7 +25,9 @@ namespace RType::Network {
 
 class UDPSocket : public ISocket {
 public:
-    UDPSocket() : _sockfd(-1), _port(0) {
+    // With reusePort, several sockets may bind the same port and the
+    // kernel load-balances incoming flows between them (SO_REUSEPORT).
+    explicit UDPSocket(bool reusePort = false) : _sockfd(-1), _port(0), _reusePort(reusePort) {
 #ifdef _WIN32
         WSADATA wsaData;
         WSAStartup(MAKEWORD(2, 2), &wsaData);
@@ -56,6 +60,16 @@ public:
             throw std::runtime_error("Failed to set SO_REUSEADDR");
         }
 
+        if (_reusePort) {
+#ifdef SO_REUSEPORT
+            if (setsockopt(_sockfd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+                throw std::runtime_error("Failed to set SO_REUSEPORT");
+            }
+#else
+            throw std::runtime_error("SO_REUSEPORT is not supported on this platform");
+#endif
+        }
+
         sockaddr_in addr{};
         addr.sin_family = AF_INET;
         addr.sin_addr.s_addr = INADDR_ANY;
@@ -99,44 +113,119 @@ public:
 #endif
     }
     
-    ssize_t sendTo(const void* data, size_t size, const IAddress& dest) override {
-        auto* udpAddr = dynamic_cast<const UDPAddress*>(&dest);
-        if (!udpAddr) {
-            throw std::runtime_error("Invalid address type for UDP socket");
+    ssize_t sendTo(const void* data, size_t size, const Endpoint& dest) override {
+        sockaddr_storage nativeAddr;
+        size_t addrLen = dest.toNative(nativeAddr, AF_INET);
+        if (addrLen == 0) {
+            return -1;
         }
         
-        const auto& nativeAddr = udpAddr->getNativeAddr();
 #ifdef _WIN32
         return sendto(_sockfd, (const char*)data, (int)size, 0,
                      reinterpret_cast<const sockaddr*>(&nativeAddr),
-                     sizeof(nativeAddr));
+                     (int)addrLen);
 #else
         return sendto(_sockfd, data, size, 0,
                      reinterpret_cast<const sockaddr*>(&nativeAddr),
-                     sizeof(nativeAddr));
+                     static_cast<socklen_t>(addrLen));
 #endif
     }
     
-    ssize_t receiveFrom(void* buffer, size_t size, IAddress& source) override {
-        auto* udpAddr = dynamic_cast<UDPAddress*>(&source);
-        if (!udpAddr) {
-            throw std::runtime_error("Invalid address type for UDP socket");
-        }
-        
-        auto& nativeAddr = udpAddr->getNativeAddr();
+    ssize_t receiveFrom(void* buffer, size_t size, Endpoint& source) override {
+        sockaddr_storage nativeAddr{};
         socklen_t addr_len = sizeof(nativeAddr);
         
 #ifdef _WIN32
-        return recvfrom(_sockfd, (char*)buffer, (int)size, 0,
-                       reinterpret_cast<sockaddr*>(&nativeAddr),
-                       &addr_len);
+        ssize_t received = recvfrom(_sockfd, (char*)buffer, (int)size, 0,
+                                    reinterpret_cast<sockaddr*>(&nativeAddr),
+                                    &addr_len);
 #else
-        return recvfrom(_sockfd, buffer, size, 0,
-                       reinterpret_cast<sockaddr*>(&nativeAddr),
-                       &addr_len);
+        ssize_t received = recvfrom(_sockfd, buffer, size, 0,
+                                    reinterpret_cast<sockaddr*>(&nativeAddr),
+                                    &addr_len);
 #endif
+        if (received >= 0) {
+            source = Endpoint::fromNative(nativeAddr);
+        }
+        return received;
     }
     
+#ifdef __linux__
+    // One sendmmsg() per MMSG_BATCH datagrams. A datagram the kernel
+    // refuses is dropped, exactly like a failed sendto().
+    size_t sendBatch(const OutgoingDatagram* packets, size_t count) override {
+        mmsghdr msgs[MMSG_BATCH];
+        iovec iovs[MMSG_BATCH];
+        sockaddr_storage addrs[MMSG_BATCH];
+        size_t sent = 0;
+        size_t done = 0;
+
+        while (done < count) {
+            size_t n = 0;
+            size_t scanned = 0;
+            while (n < MMSG_BATCH && done + scanned < count) {
+                const OutgoingDatagram& packet = packets[done + scanned];
+                ++scanned;
+                size_t addrLen = packet.dest.toNative(addrs[n], AF_INET);
+                if (addrLen == 0) {
+                    continue;
+                }
+                iovs[n].iov_base = const_cast<void*>(packet.data);
+                iovs[n].iov_len = packet.size;
+                std::memset(&msgs[n], 0, sizeof(mmsghdr));
+                msgs[n].msg_hdr.msg_name = &addrs[n];
+                msgs[n].msg_hdr.msg_namelen = static_cast<socklen_t>(addrLen);
+                msgs[n].msg_hdr.msg_iov = &iovs[n];
+                msgs[n].msg_hdr.msg_iovlen = 1;
+                ++n;
+            }
+
+            size_t offset = 0;
+            while (offset < n) {
+                int result = ::sendmmsg(_sockfd, msgs + offset, static_cast<unsigned int>(n - offset), 0);
+                if (result < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    offset += 1;
+                    continue;
+                }
+                sent += static_cast<size_t>(result);
+                offset += static_cast<size_t>(result);
+            }
+            done += scanned;
+        }
+        return sent;
+    }
+
+    size_t receiveBatch(ReceiveSlot* slots, size_t count) override {
+        mmsghdr msgs[MMSG_BATCH];
+        iovec iovs[MMSG_BATCH];
+        sockaddr_storage addrs[MMSG_BATCH];
+        size_t n = std::min(MMSG_BATCH, count);
+
+        for (size_t i = 0; i < n; ++i) {
+            iovs[i].iov_base = slots[i].buffer;
+            iovs[i].iov_len = slots[i].capacity;
+            std::memset(&msgs[i], 0, sizeof(mmsghdr));
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int result = ::recvmmsg(_sockfd, msgs, static_cast<unsigned int>(n), MSG_DONTWAIT, nullptr);
+        if (result <= 0)
+            return 0;
+
+        // Truncated datagrams come back empty so callers drop them.
+        for (int i = 0; i < result; ++i) {
+            slots[i].source = Endpoint::fromNative(addrs[i]);
+            slots[i].size = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) ? 0 : msgs[i].msg_len;
+        }
+        return static_cast<size_t>(result);
+    }
+#endif
+
     void close() override {
 #ifdef _WIN32
         if (_sockfd != INVALID_SOCKET) {
@@ -155,8 +244,11 @@ public:
     uint16_t getPort() const override { return _port; }
 
 private:
+    static constexpr size_t MMSG_BATCH = 64;
+
     int _sockfd;
     uint16_t _port;
+    bool _reusePort;
 };
 
 } // namespace RType::Network
\ No newline at end of file
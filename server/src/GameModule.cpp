@@ -8,6 +8,7 @@
 #include "engine/gameplay/Score.hpp"
 #include "protocol/Protocol.hpp"
 #include "levels/LevelManager.hpp"
+#include "metrics/Profiler.hpp"
 #include <unordered_map>
 #include <iostream>
 #include <algorithm>
@@ -35,6 +36,7 @@ GameModule::GameModule()
     , _inLevelTransition(false)
     , _transitionTimer(0.f)
     , _gameOverFlag(false)
+    , _tick(0)
 {
     _movementSystem = std::make_unique<MovementSystem>();
 }
@@ -42,11 +44,6 @@ GameModule::GameModule()
 
 void GameModule::init()
 {
-    std::unique_lock<std::shared_mutex> regLock(_registryMutex);
-    std::lock_guard<std::mutex> playerLock(_playerMutex);
-    std::lock_guard<std::mutex> eventLock(_eventMutex);
-    std::lock_guard<std::mutex> scoreLock(_scoreMutex);
-    
     _playerStates.clear();
     _playerEntities.clear();
     _movementSystem = std::make_unique<MovementSystem>();
@@ -83,11 +80,11 @@ void GameModule::init()
 
 void GameModule::update(float dt)
 {
-    std::unique_lock<std::shared_mutex> lock(_registryMutex);
-    
     auto* currentLevel = _levelManager->getCurrentLevel();
     if (!currentLevel) return;
 
+    ++_tick;
+
     if (_inLevelTransition) {
         _transitionTimer += dt;
         
@@ -160,30 +157,46 @@ void GameModule::update(float dt)
         return;
     }
 
-    currentLevel->update(dt, _registry);
-    _movementSystem->update(_registry, dt);
+    using RType::Metrics::Phase;
+
+    {
+        RTYPE_PROFILE_SCOPE(Phase::LEVEL_UPDATE);
+        currentLevel->update(dt, _registry);
+    }
 
-    _registry.each<Transform, Controllable>([](EntityID, Transform& t, Controllable&) {
-        constexpr float PLAYER_WIDTH = 100.f;
-        constexpr float PLAYER_HEIGHT = 60.f;
+    {
+        RTYPE_PROFILE_SCOPE(Phase::MOVEMENT);
+        _movementSystem->update(_registry, dt);
+    }
 
-        if (t.x < 0.f) t.x = 0.f;
-        if (t.x + PLAYER_WIDTH > WORLD_WIDTH) t.x = WORLD_WIDTH - PLAYER_WIDTH;
-        if (t.y < 0.f) t.y = 0.f;
-        if (t.y + PLAYER_HEIGHT > WORLD_HEIGHT) t.y = WORLD_HEIGHT - PLAYER_HEIGHT;
-    });
+    {
+        RTYPE_PROFILE_SCOPE(Phase::CLAMP);
+        _registry.each<Transform, Controllable>([](EntityID, Transform& t, Controllable&) {
+            constexpr float PLAYER_WIDTH = 100.f;
+            constexpr float PLAYER_HEIGHT = 60.f;
+
+            if (t.x < 0.f) t.x = 0.f;
+            if (t.x + PLAYER_WIDTH > WORLD_WIDTH) t.x = WORLD_WIDTH - PLAYER_WIDTH;
+            if (t.y < 0.f) t.y = 0.f;
+            if (t.y + PLAYER_HEIGHT > WORLD_HEIGHT) t.y = WORLD_HEIGHT - PLAYER_HEIGHT;
+        });
+    }
 
-    _registry.each<Controllable>([dt](EntityID, Controllable& c) {
-        if (!c.canShoot) {
-            c.currentCooldown -= dt;
-            if (c.currentCooldown <= 0.f) {
-                c.canShoot = true;
-                c.currentCooldown = 0.f;
+    {
+        RTYPE_PROFILE_SCOPE(Phase::COOLDOWNS);
+        _registry.each<Controllable>([dt](EntityID, Controllable& c) {
+            if (!c.canShoot) {
+                c.currentCooldown -= dt;
+                if (c.currentCooldown <= 0.f) {
+                    c.canShoot = true;
+                    c.currentCooldown = 0.f;
+                }
             }
-        }
-    });
+        });
+    }
 
     if (!_bossSpawned) {
+        RTYPE_PROFILE_SCOPE(Phase::BOSS_CHECK);
         for (const auto& [client_id, entity_id] : _playerEntities) {
             if (_registry.has<Score>(entity_id)) {
                 const Score& s = _registry.get<Score>(entity_id);
@@ -199,11 +212,30 @@ void GameModule::update(float dt)
         }
     }
 
-    updateChargeStates(dt);
-    updateEnemies(dt, currentLevel);
-    handleEnemyCollisions();
-    cleanupProjectiles();
-    _registry.cleanup();
+    {
+        RTYPE_PROFILE_SCOPE(Phase::CHARGE_STATES);
+        updateChargeStates(dt);
+    }
+
+    {
+        RTYPE_PROFILE_SCOPE(Phase::ENEMIES);
+        updateEnemies(dt, currentLevel);
+    }
+
+    {
+        RTYPE_PROFILE_SCOPE(Phase::COLLISIONS);
+        handleEnemyCollisions();
+    }
+
+    {
+        RTYPE_PROFILE_SCOPE(Phase::PROJECTILE_CLEANUP);
+        cleanupProjectiles();
+    }
+
+    {
+        RTYPE_PROFILE_SCOPE(Phase::REGISTRY_CLEANUP);
+        _registry.cleanup();
+    }
 
     if (currentLevel->isComplete(_registry, _bossSpawned)) {
         std::cout << "[GameModule] Level complete!" << std::endl;
@@ -222,7 +254,6 @@ void GameModule::update(float dt)
                           << currentLevelName << " -> " << nextLevelName << std::endl;
                 
                 {
-                    std::lock_guard<std::mutex> eventLock(_eventMutex);
                     RType::Protocol::GameEvent evt;
                     evt.event_type = RType::Protocol::GameEventType::LEVEL_COMPLETE;
                     evt.entityId = 0;
@@ -245,26 +276,21 @@ void GameModule::update(float dt)
 
 std::vector<EntitySnapshot> GameModule::getWorldSnapshot()
 {
-    std::shared_lock<std::shared_mutex> regLock(_registryMutex);
-    
     std::vector<EntitySnapshot> snapshots;
 
-    std::unordered_map<EntityID, uint32_t> entityToClient;
-    {
-        std::lock_guard<std::mutex> playerLock(_playerMutex);
-        for (const auto& [client_id, entity_id] : _playerEntities) {
-            entityToClient[entity_id] = client_id;
-        }
+    std::unordered_map<EntityID, std::pair<uint32_t, uint8_t>> entityToPlayer;
+    for (const auto& [client_id, entity_id] : _playerEntities) {
+        auto stateIt = _playerStates.find(client_id);
+        uint8_t slot = (stateIt != _playerStates.end()) ? stateIt->second.slot : 0;
+        entityToPlayer[entity_id] = {client_id, slot};
     }
 
     _registry.each<Transform>([&](EntityID id, const Transform& transform) {
         EntitySnapshot snap;
-        auto it = entityToClient.find(id);
-        if (it != entityToClient.end()) {
-            snap.entity_id = it->second;
-            std::lock_guard<std::mutex> playerLock(_playerMutex);
-            auto stateIt = _playerStates.find(it->second);
-            snap.player_slot = (stateIt != _playerStates.end()) ? stateIt->second.slot : 0;
+        auto it = entityToPlayer.find(id);
+        if (it != entityToPlayer.end()) {
+            snap.entity_id = it->second.first;
+            snap.player_slot = it->second.second;
         } else {
             snap.entity_id = 1000 + id;
             snap.player_slot = 255;
@@ -324,9 +350,19 @@ std::vector<EntitySnapshot> GameModule::getWorldSnapshot()
     return snapshots;
 }
 
+std::shared_ptr<const WorldFrame> GameModule::publishFrame()
+{
+    auto frame = std::make_shared<WorldFrame>();
+    frame->tick = _tick;
+    frame->entities = getWorldSnapshot();
+
+    std::shared_ptr<const WorldFrame> published = std::move(frame);
+    _frame.publish(published);
+    return published;
+}
+
 std::vector<LocalGameEvent> GameModule::pollEvents()
 {
-    std::lock_guard<std::mutex> lock(_eventMutex);
     std::vector<LocalGameEvent> events;
     while (!_eventQueue.empty()) {
         events.push_back(_eventQueue.front());
@@ -337,7 +373,6 @@ std::vector<LocalGameEvent> GameModule::pollEvents()
 
 std::vector<RType::Protocol::GameEvent> GameModule::pollNetworkEvents()
 {
-    std::lock_guard<std::mutex> lock(_eventMutex);
     std::vector<RType::Protocol::GameEvent> events;
     while (!_networkEventQueue.empty()) {
         events.push_back(_networkEventQueue.front());
@@ -1,17 +1,98 @@
 #include "NetworkModule.hpp"
+#include "metrics/ServerMetrics.hpp"
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <cstring>
+#include <stdexcept>
 
 namespace RType::Network {
 
+namespace {
+
+// Messages for one client waiting to leave as a single BUNDLE datagram:
+// a Protocol::BundleHeader, then a uint16_t length and the message bytes
+// for each one. Reliable and unreliable messages go in separate frames.
+struct OutgoingFrame {
+    std::shared_ptr<Server::Client> client;
+    bool reliable = false;
+    std::vector<uint8_t> bytes;
+    size_t count = 0;
+};
+
+// Datagrams queued by the current thread between beginBatch() and flush().
+// The vectors keep their capacity, so steady-state batching never allocates.
+struct OutgoingBatch {
+    const void* owner = nullptr;
+    std::vector<uint8_t> bytes;
+    std::vector<std::pair<size_t, size_t>> spans;
+    std::vector<Endpoint> dests;
+    std::vector<OutgoingDatagram> datagrams;
+    std::vector<uint8_t> stamped;   // unbatched packet with acks written in
+    std::vector<uint8_t> message;   // message being split into fragments
+    std::vector<uint8_t> fragment;
+    std::vector<uint8_t> ordered;   // message wrapped for the ordered channel
+    std::vector<OutgoingFrame> frames;   // [0, open_frames) are in use
+    size_t open_frames = 0;
+    std::unordered_map<uint64_t, size_t> frame_index;
+};
+
+thread_local OutgoingBatch t_outgoing;
+
+// Retransmit timers carry the client id and the per-client sequence; ack
+// flush timers set the top bit and carry only the client id.
+constexpr uint64_t ACK_FLUSH_TAG = 1ULL << 63;
+
+uint64_t retransmitKey(uint32_t client_id, uint16_t sequence)
+{
+    return (static_cast<uint64_t>(client_id) << 16) | sequence;
+}
+
+uint64_t ackFlushKey(uint32_t client_id)
+{
+    return ACK_FLUSH_TAG | client_id;
+}
+
+uint64_t frameKey(uint32_t client_id, bool reliable)
+{
+    return (static_cast<uint64_t>(client_id) << 1) | (reliable ? 1 : 0);
+}
+
+} // namespace
+
+namespace {
+
+std::vector<std::unique_ptr<ISocket>> single(std::unique_ptr<ISocket> socket)
+{
+    std::vector<std::unique_ptr<ISocket>> sockets;
+    sockets.push_back(std::move(socket));
+    return sockets;
+}
+
+} // namespace
+
 NetworkModule::NetworkModule(std::unique_ptr<ISocket> socket)
-    : _socket(std::move(socket))
+    : NetworkModule(single(std::move(socket)))
+{
+}
+
+NetworkModule::NetworkModule(std::vector<std::unique_ptr<ISocket>> sockets)
+    : _socket(nullptr)
     , _port(0)
     , _running(false)
     , _next_client_id(1)
-    , _next_sequence(1)
+    , _mtu(DEFAULT_MTU)
+    , _next_message_id(0)
+    , _retransmit_timers(TIMER_SLOTS, TIMER_RESOLUTION)
 {
-    std::memset(_player_slots, 0, sizeof(_player_slots));
+    if (sockets.empty())
+        throw std::invalid_argument("NetworkModule needs at least one socket");
+
+    size_t poolSlabs = std::max(RECV_POOL_SLABS / sockets.size(), RECV_BATCH * 4);
+    for (auto& socket : sockets) {
+        _shards.push_back(std::make_unique<ReceiveShard>(std::move(socket), poolSlabs));
+    }
+    _socket = _shards.front()->socket.get();
 }
 
 NetworkModule::~NetworkModule()
@@ -25,18 +106,30 @@ bool NetworkModule::start(uint16_t port)
         return false;
     
     try {
-        _socket->bind(port);
-        _socket->setNonBlocking(true);
+        for (auto& shard : _shards) {
+            shard->socket->bind(port);
+            shard->socket->setNonBlocking(true);
+            shard->waiter = std::make_unique<SocketWaiter>(shard->socket->getFd());
+        }
         _port = port;
         
         _running = true;
-        _receive_thread = std::thread(&NetworkModule::receiveLoop, this);
-        _retry_thread = std::thread(&NetworkModule::retryLoop, this);
+        for (auto& shard : _shards) {
+            shard->thread = std::thread(&NetworkModule::receiveLoop, this, std::ref(*shard));
+        }
+
+        if (_shards.size() > 1) {
+            std::cout << "[NetworkModule] Receiving on " << _shards.size()
+                      << " SO_REUSEPORT shards" << std::endl;
+        }
         
         return true;
     }
     catch (const std::exception& e) {
         std::cerr << "[NetworkModule] Failed to start: " << e.what() << std::endl;
+        for (auto& shard : _shards) {
+            shard->socket->close();
+        }
         return false;
     }
 }
@@ -47,142 +140,293 @@ void NetworkModule::stop()
         return;
     
     _running = false;
+    for (auto& shard : _shards) {
+        shard->waiter->wake();
+    }
     
-    if (_receive_thread.joinable())
-        _receive_thread.join();
-    
-    if (_retry_thread.joinable())
-        _retry_thread.join();
+    for (auto& shard : _shards) {
+        if (shard->thread.joinable())
+            shard->thread.join();
+    }
     
-    _socket->close();
+    for (auto& shard : _shards) {
+        shard->socket->close();
+    }
 }
 
-void NetworkModule::receiveLoop()
+void NetworkModule::receiveLoop(ReceiveShard& shard)
 {
-    std::vector<uint8_t> buffer(MAX_PACKET_SIZE);
+    // Each slot receives straight into a pooled slab that is then handed on
+    // with the message. If the pool runs dry the slot falls back to a
+    // scratch buffer and its datagram is dropped.
+    std::vector<uint8_t> scratch(MAX_PACKET_SIZE * RECV_BATCH);
+    std::array<PacketBuffer, RECV_BATCH> held;
+    std::array<ReceiveSlot, RECV_BATCH> slots;
+    bool drivesTimers = &shard == _shards.front().get();
     
     while (_running)
     {
-        UDPAddress from;
-        ssize_t bytes = _socket->receiveFrom(buffer.data(), buffer.size(), from);
-        
-        if (bytes < 0) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            continue;
+        if (drivesTimers)
+            serviceRetransmits();
+
+        for (size_t i = 0; i < RECV_BATCH; ++i) {
+            if (!held[i])
+                held[i] = shard.pool.acquire();
+            uint8_t* target = held[i] ? held[i].data() : scratch.data() + i * MAX_PACKET_SIZE;
+            slots[i] = ReceiveSlot{target, MAX_PACKET_SIZE, 0, Endpoint()};
         }
+
+        size_t count = shard.socket->receiveBatch(slots.data(), slots.size());
         
-        if (static_cast<size_t>(bytes) < sizeof(Protocol::PacketHeader)) {
+        // Drained: sleep in the kernel until a datagram arrives or stop()
+        // wakes us, so an idle server costs nothing and a packet is picked
+        // up as soon as it lands.
+        if (count == 0) {
+            shard.waiter->wait(drivesTimers ? retransmitWaitTimeout() : std::chrono::milliseconds(-1));
             continue;
         }
-        
-        std::vector<uint8_t> packet(buffer.begin(), buffer.begin() + bytes);
-        auto addr = std::make_shared<UDPAddress>(from);
-        processRawPacket(packet, bytes, addr);
+
+        Metrics::ServerMetrics::instance().recordRecvCall();
+
+        // ACKs for the whole batch leave in one send call.
+        SendBatch acks(*this);
+
+        for (size_t i = 0; i < count; ++i) {
+            const ReceiveSlot& slot = slots[i];
+            if (slot.size < sizeof(Protocol::PacketHeader)) {
+                continue;
+            }
+            if (!held[i]) {
+                Metrics::ServerMetrics::instance().recordPoolExhausted();
+                continue;
+            }
+
+            held[i].resize(slot.size);
+            processRawPacket(shard, std::move(held[i]), slot.source);
+        }
     }
 }
 
-void NetworkModule::retryLoop()
+void NetworkModule::serviceRetransmits()
 {
-    while (_running)
+    auto now = std::chrono::steady_clock::now();
+    auto& metrics = Metrics::ServerMetrics::instance();
+
+    // Skip the client table lock entirely while nothing is in flight.
     {
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        
-        auto now = std::chrono::steady_clock::now();
-        
         std::lock_guard<std::mutex> lock(_reliable_mutex);
-        
-        for (auto it = _pending_reliable.begin(); it != _pending_reliable.end(); )
-        {
-            auto& pending = it->second;
-            
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                now - pending.last_sent
-            );
-            
-            if (elapsed >= RETRY_TIMEOUT) {
-                if (pending.retries >= MAX_RETRIES) {
-                    it = _pending_reliable.erase(it);
-                    continue;
-                }
-                
-                _socket->sendTo(pending.data.data(), pending.data.size(), *pending.dest);
-                pending.last_sent = now;
-                pending.retries++;
-            }
-            
-            ++it;
-        }
+        if (_retransmit_timers.empty())
+            return;
     }
+
+    std::lock_guard<std::mutex> clientsLock(_clients_mutex);
+    std::lock_guard<std::mutex> lock(_reliable_mutex);
+    SendBatch retransmits(*this);
+
+    _retransmit_timers.advance(now, [&](uint64_t key) {
+        bool ackFlush = (key & ACK_FLUSH_TAG) != 0;
+        auto client = _clients_by_id.find(static_cast<uint32_t>(ackFlush ? key : key >> 16));
+        if (client == _clients_by_id.end())
+            return;
+
+        if (ackFlush) {
+            flushAck(*client->second);
+            return;
+        }
+
+        auto& channel = client->second->reliableChannel();
+        auto it = channel.pending.find(static_cast<uint16_t>(key));
+        if (it == channel.pending.end())
+            return;
+
+        auto& pending = it->second;
+        if (pending.retries >= MAX_RETRIES) {
+            metrics.recordReliableDropped();
+            channel.pending.erase(it);
+            return;
+        }
+
+        auto late = now - pending.deadline;
+        metrics.retransmitLateness().observe(static_cast<uint64_t>(
+            std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::microseconds>(late).count())));
+
+        transmit(pending.data.data(), pending.data.size(), client->second->getAddress(), client->second.get());
+        metrics.recordRetransmit();
+        channel.rtt.backoff(now);
+        pending.last_sent = now;
+        pending.deadline = now + channel.rtt.rto;
+        pending.retries++;
+        pending.timer = _retransmit_timers.schedule(pending.deadline, key);
+    });
+}
+
+std::chrono::milliseconds NetworkModule::retransmitWaitTimeout()
+{
+    using namespace std::chrono;
+
+    std::lock_guard<std::mutex> lock(_reliable_mutex);
+    _timer_wait_until = _retransmit_timers.nextDeadline();
+    if (_timer_wait_until == steady_clock::time_point::max())
+        return milliseconds(-1);
+    auto wait = ceil<milliseconds>(_timer_wait_until - steady_clock::now());
+    return std::max(wait, milliseconds(0));
 }
 
-void NetworkModule::processRawPacket(const std::vector<uint8_t>& buffer, 
-                                      size_t size, 
-                                      const std::shared_ptr<IAddress>& from)
+bool NetworkModule::wakesTimerWait(std::chrono::steady_clock::time_point deadline)
 {
-    const auto& header = *reinterpret_cast<const Protocol::PacketHeader*>(buffer.data());
+    // The timer-driving receive loop may be asleep until a later deadline,
+    // or with none at all.
+    if (deadline >= _timer_wait_until)
+        return false;
+    _timer_wait_until = deadline;
+    return true;
+}
+
+void NetworkModule::processRawPacket(ReceiveShard& shard, PacketBuffer packet, const Endpoint& from)
+{
+    size_t size = packet.size();
+    const auto& header = *reinterpret_cast<const Protocol::PacketHeader*>(packet.data());
     
     if (!validatePacket(header, size)) {
         return;
     }
-    
-    if (header.type == Protocol::PacketType::ACK) {
-        if (size >= sizeof(Protocol::AckPacket)) {
-            const auto& ack = *reinterpret_cast<const Protocol::AckPacket*>(buffer.data());
-            handleAck(ack.ack_sequence, from);
+
+    Metrics::ServerMetrics::instance().recordPacketIn(static_cast<uint8_t>(header.type), size);
+
+    // The shared_ptr keeps the client's channel alive even if it is
+    // disconnected while this packet is being handled.
+    std::shared_ptr<Server::Client> client;
+    {
+        std::lock_guard<std::mutex> lock(_clients_mutex);
+        auto it = _clients_by_addr.find(from);
+        if (it != _clients_by_addr.end()) {
+            client = it->second;
+            client->updateLastActivity();
         }
-        return;
     }
     
-    if (header.isReliable()) {
-        {
-            std::lock_guard<std::mutex> lock(_dedup_mutex);
-            
-            auto& sequences = _received_sequences[from];
-            
-            if (sequences.count(header.sequence_number)) {
-                sendAck(header.sequence_number, *from);
-                return;
-            }
-            
-            sequences.insert(header.sequence_number);
-            
-            if (sequences.size() > MAX_SEQUENCE_HISTORY) {
-                auto oldest = *sequences.begin();
-                sequences.erase(oldest);
-            }
+    if (client && header.hasAcks())
+        handleAcks(*client, header.ack, header.ack_bits);
+
+    // Replies to our own pings stop here; the dispatcher never sees them.
+    if (client && header.type == Protocol::PacketType::PONG && handlePong(*client, header.sequence_number))
+        return;
+    
+    if (header.type == Protocol::PacketType::ACK) {
+        if (client && size >= sizeof(Protocol::AckPacket)) {
+            const auto& ack = *reinterpret_cast<const Protocol::AckPacket*>(packet.data());
+            handleAcks(*client, ack.ack_sequence, 0);
         }
-        
-        sendAck(header.sequence_number, *from);
+        return;
     }
     
-    {
-        std::lock_guard<std::mutex> lock(_clients_mutex);
-        auto it = _clients_by_addr.find(from);
-        if (it != _clients_by_addr.end()) {
-            it->second->updateLastActivity();
-        }
+    if (header.isReliable() && !acceptReliable(client.get(), from, header.sequence_number))
+        return;
+
+    if (header.type == Protocol::PacketType::FRAGMENT) {
+        reassemble(shard, packet, from);
+        return;
     }
     
     ReceivedMessage msg;
     msg.packet_type = static_cast<uint8_t>(header.type);
     msg.payload_size = size;
-    msg.payload.assign(buffer.begin(), buffer.begin() + size);
+    msg.payload = std::move(packet);
     msg.source_addr = from;
+    msg.client_id = client ? client->getId() : 0;
     
+    bool was_empty;
     {
-        std::lock_guard<std::mutex> lock(_clients_mutex);
-        auto it = _clients_by_addr.find(from);
-        if (it != _clients_by_addr.end()) {
-            msg.client_id = it->second->getId();
-        } else {
-            msg.client_id = 0;
-        }
+        std::lock_guard<std::mutex> lock(shard.queue_mutex);
+        was_empty = shard.queue.empty();
+        shard.queue.push_back(std::move(msg));
     }
-    
+    // A non-empty queue has already been signalled.
+    if (was_empty)
+        signalMessages();
+}
+
+void NetworkModule::signalMessages()
+{
     {
-        std::lock_guard<std::mutex> lock(_queue_mutex);
-        _message_queue.push(std::move(msg));
+        std::lock_guard<std::mutex> lock(_ready_mutex);
+        _messages_ready = true;
     }
+    _ready.notify_one();
+}
+
+bool NetworkModule::acceptReliable(Server::Client* client, const Endpoint& from, uint16_t sequence)
+{
+    // Peers without a session get an explicit ACK straight away. Nothing
+    // is remembered about them, so forged source addresses cost no
+    // memory: their only reliable packet is CONNECT_REQUEST, and a room
+    // answers a repeated one with the same reply.
+    if (!client) {
+        sendAck(sequence, from, nullptr);
+        return true;
+    }
+
+    // Clients are acked through the header of the next packet sent to
+    // them, or by flushAck() if nothing goes out for FLUSH_DELAY.
+    // Duplicates are acked again: the first ack may have been lost.
+    auto& channel = client->reliableChannel();
+    bool fresh;
+    bool inWindow;
+    bool armFlush = false;
+    {
+        std::lock_guard<std::mutex> lock(_dedup_mutex);
+        fresh = !channel.received.contains(sequence);
+        if (fresh)
+            channel.received.insert(sequence);
+        inWindow = channel.acks.record(sequence);
+        if (inWindow && !channel.ack_pending) {
+            channel.ack_pending = true;
+            armFlush = true;
+        }
+    }
+
+    if (!inWindow)
+        sendAck(sequence, from, client);
+
+    if (armFlush) {
+        bool wake;
+        {
+            std::lock_guard<std::mutex> lock(_reliable_mutex);
+            auto deadline = std::chrono::steady_clock::now() + AckWindow::FLUSH_DELAY;
+            _retransmit_timers.schedule(deadline, ackFlushKey(client->getId()));
+            wake = wakesTimerWait(deadline);
+        }
+        if (wake && _running)
+            _shards.front()->waiter->wake();
+    }
+
+    return fresh;
+}
+
+void NetworkModule::reassemble(ReceiveShard& shard, const PacketBuffer& packet, const Endpoint& from)
+{
+    if (packet.size() < sizeof(Protocol::FragmentHeader))
+        return;
+
+    Protocol::FragmentHeader header;
+    std::memcpy(&header, packet.data(), sizeof(header));
+
+    Reassembler::Fragment fragment{header.message_id, header.fragment_index, header.fragment_count,
+                                   header.total_size, header.offset,
+                                   packet.data() + sizeof(header), packet.size() - sizeof(header)};
+    const auto* message = shard.reassembly.add(from, fragment, std::chrono::steady_clock::now());
+
+    if (uint64_t dropped = shard.reassembly.takeDropped())
+        Metrics::ServerMetrics::instance().recordReassemblyDropped(dropped);
+
+    if (!message || message->size() < sizeof(Protocol::PacketHeader))
+        return;
+
+    // The whole message goes through the normal path, as if it had
+    // arrived in one datagram.
+    PacketBuffer whole;
+    whole.assign(message->data(), message->data() + message->size());
+    processRawPacket(shard, std::move(whole), from);
 }
 
 bool NetworkModule::validatePacket(const Protocol::PacketHeader& header, 
@@ -197,57 +441,388 @@ bool NetworkModule::validatePacket(const Protocol::PacketHeader& header,
     return true;
 }
 
-std::vector<ReceivedMessage> NetworkModule::pollMessages()
+void NetworkModule::pollMessages(std::vector<ReceivedMessage>& out)
 {
-    std::lock_guard<std::mutex> lock(_queue_mutex);
-    
-    std::vector<ReceivedMessage> messages;
+    // The caller's vector swaps storage with the first non-empty shard
+    // queue, so both keep their capacity from one poll to the next; other
+    // shards are appended.
+    out.clear();
+
+    for (auto& shard : _shards) {
+        std::lock_guard<std::mutex> lock(shard->queue_mutex);
+        if (out.empty()) {
+            out.swap(shard->queue);
+        } else {
+            std::move(shard->queue.begin(), shard->queue.end(), std::back_inserter(out));
+            shard->queue.clear();
+        }
+    }
     
-    while (!_message_queue.empty()) {
-        messages.push_back(std::move(_message_queue.front()));
-        _message_queue.pop();
+    Metrics::ServerMetrics::instance().recordQueueDepth(out.size());
+}
+
+void NetworkModule::waitForMessages(std::chrono::steady_clock::time_point deadline)
+{
+    std::unique_lock<std::mutex> lock(_ready_mutex);
+    _ready.wait_until(lock, deadline, [this] { return _messages_ready; });
+    _messages_ready = false;
+}
+
+void NetworkModule::wakeWaiter()
+{
+    signalMessages();
+}
+
+void NetworkModule::sendRawPacket(const void* data, size_t size, const Endpoint& to,
+                                  const std::shared_ptr<Server::Client>& client)
+{
+    if (size > _mtu.load(std::memory_order_relaxed)) {
+        sendFragmented(data, size, to, client);
+        return;
+    }
+
+    const auto& header = *reinterpret_cast<const Protocol::PacketHeader*>(data);
+    Metrics::ServerMetrics::instance().recordPacketOut(static_cast<uint8_t>(header.type), size);
+
+    if (coalesce(data, size, client))
+        return;
+
+    deliver(data, size, to, client.get());
+}
+
+void NetworkModule::deliver(const void* data, size_t size, const Endpoint& to, Server::Client* client)
+{
+    // Reliability needs a session to hang off; a reliable packet to an
+    // unregistered address goes out once.
+    const auto& header = *reinterpret_cast<const Protocol::PacketHeader*>(data);
+    if (header.isReliable() && client) {
+        sendReliable(*client, data, size);
+        return;
     }
     
-    return messages;
+    transmit(data, size, to, client);
 }
 
-void NetworkModule::sendRawPacket(const void* data, size_t size, const IAddress& to, bool reliable)
+bool NetworkModule::coalesce(const void* data, size_t size, const std::shared_ptr<Server::Client>& client)
 {
-    if (reliable) {
-        const auto& header = *reinterpret_cast<const Protocol::PacketHeader*>(data);
-        
-        std::vector<uint8_t> packet(static_cast<const uint8_t*>(data),
-                                     static_cast<const uint8_t*>(data) + size);
-        
-        PendingReliablePacket pending;
-        pending.data = std::move(packet);
-        pending.dest = to.clone();
-        pending.last_sent = std::chrono::steady_clock::now();
-        pending.sequence = header.sequence_number;
+    // Only within a batch, and only for clients with a session. The
+    // connect reply always travels alone: the client reads it with a
+    // plain recvfrom() before its receive loop is running.
+    if (t_outgoing.owner != this || !client)
+        return false;
+    const auto& header = *reinterpret_cast<const Protocol::PacketHeader*>(data);
+    if (header.type == Protocol::PacketType::CONNECT_RESPONSE)
+        return false;
+
+    size_t mtu = _mtu.load(std::memory_order_relaxed);
+    constexpr size_t ENTRY_PREFIX = Protocol::BundleHeader::ENTRY_PREFIX;
+    if (sizeof(Protocol::BundleHeader) + ENTRY_PREFIX + size > mtu)
+        return false;
+
+    auto& batch = t_outgoing;
+    bool reliable = header.isReliable();
+    auto [it, added] = batch.frame_index.try_emplace(frameKey(client->getId(), reliable), batch.open_frames);
+    if (added) {
+        if (batch.open_frames == batch.frames.size())
+            batch.frames.emplace_back();
+        OutgoingFrame& frame = batch.frames[batch.open_frames++];
+        frame.client = client;
+        frame.reliable = reliable;
+        frame.count = 0;
+        frame.bytes.resize(sizeof(Protocol::BundleHeader));
+    }
+
+    OutgoingFrame& frame = batch.frames[it->second];
+    if (frame.bytes.size() + ENTRY_PREFIX + size > mtu || frame.count == UINT8_MAX)
+        closeFrame(it->second);
+
+    // The bundle carries reliability, so the copy inside it must not be
+    // acked or deduplicated on its own.
+    auto length = static_cast<uint16_t>(size);
+    size_t offset = frame.bytes.size();
+    frame.bytes.resize(offset + ENTRY_PREFIX + size);
+    std::memcpy(frame.bytes.data() + offset, &length, ENTRY_PREFIX);
+    std::memcpy(frame.bytes.data() + offset + ENTRY_PREFIX, data, size);
+    reinterpret_cast<Protocol::PacketHeader*>(frame.bytes.data() + offset + ENTRY_PREFIX)->setReliable(false);
+    ++frame.count;
+    return true;
+}
+
+void NetworkModule::closeFrame(size_t index)
+{
+    OutgoingFrame& frame = t_outgoing.frames[index];
+    Server::Client* client = frame.client.get();
+    constexpr size_t ENTRY_PREFIX = Protocol::BundleHeader::ENTRY_PREFIX;
+
+    if (frame.count == 1) {
+        // Nothing to share the datagram with: send the message as it was.
+        uint8_t* message = frame.bytes.data() + sizeof(Protocol::BundleHeader) + ENTRY_PREFIX;
+        reinterpret_cast<Protocol::PacketHeader*>(message)->setReliable(frame.reliable);
+        deliver(message, frame.bytes.size() - sizeof(Protocol::BundleHeader) - ENTRY_PREFIX,
+                client->getAddress(), client);
+    } else if (frame.count > 1) {
+        Protocol::BundleHeader header;
+        header.header.setReliable(frame.reliable);
+        header.message_count = static_cast<uint8_t>(frame.count);
+        std::memcpy(frame.bytes.data(), &header, sizeof(header));
+        deliver(frame.bytes.data(), frame.bytes.size(), client->getAddress(), client);
+        Metrics::ServerMetrics::instance().recordBundle(frame.count);
+    }
+
+    frame.count = 0;
+    frame.bytes.resize(sizeof(Protocol::BundleHeader));
+}
+
+void NetworkModule::sendFragmented(const void* data, size_t size, const Endpoint& to,
+                                   const std::shared_ptr<Server::Client>& client)
+{
+    size_t chunk = _mtu.load(std::memory_order_relaxed) - sizeof(Protocol::FragmentHeader);
+    size_t count = (size + chunk - 1) / chunk;
+    if (count > Reassembler::MAX_FRAGMENTS || size > Reassembler::MAX_MESSAGE_SIZE) {
+        std::cerr << "[NetworkModule] Dropping " << size << "-byte message: too large to fragment" << std::endl;
+        return;
+    }
+
+    // Each fragment is sent reliably if the message was, so the copy the
+    // peer reassembles must not be acked or deduplicated a second time.
+    auto* bytes = static_cast<const uint8_t*>(data);
+    auto& message = t_outgoing.message;
+    message.assign(bytes, bytes + size);
+    auto* inner = reinterpret_cast<Protocol::PacketHeader*>(message.data());
+    bool reliable = inner->isReliable();
+    inner->setReliable(false);
+
+    Protocol::FragmentHeader header;
+    header.header.setReliable(reliable);
+    header.message_id = _next_message_id.fetch_add(1, std::memory_order_relaxed);
+    header.fragment_count = static_cast<uint8_t>(count);
+    header.total_size = static_cast<uint32_t>(size);
+
+    auto& fragment = t_outgoing.fragment;
+    for (size_t i = 0; i < count; ++i) {
+        size_t offset = i * chunk;
+        size_t piece = std::min(chunk, size - offset);
+        header.fragment_index = static_cast<uint8_t>(i);
+        header.offset = static_cast<uint32_t>(offset);
+
+        fragment.resize(sizeof(header) + piece);
+        std::memcpy(fragment.data(), &header, sizeof(header));
+        std::memcpy(fragment.data() + sizeof(header), message.data() + offset, piece);
+        sendRawPacket(fragment.data(), fragment.size(), to, client);
+    }
+
+    Metrics::ServerMetrics::instance().recordFragmented(count);
+}
+
+void NetworkModule::setMtu(size_t mtu)
+{
+    _mtu.store(std::clamp(mtu, MIN_MTU, MAX_PACKET_SIZE), std::memory_order_relaxed);
+}
+
+void NetworkModule::sendReliable(Server::Client& client, const void* data, size_t size)
+{
+    auto& channel = client.reliableChannel();
+    auto now = std::chrono::steady_clock::now();
+
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(_reliable_mutex);
+
+        // The sender's sequence number is replaced by one from this
+        // client's own sequence space.
+        uint16_t sequence = channel.nextSequence();
+        auto& pending = channel.pending[sequence];
+        _retransmit_timers.cancel(pending.timer);
+
+        auto* bytes = static_cast<const uint8_t*>(data);
+        pending.data.assign(bytes, bytes + size);
+        reinterpret_cast<Protocol::PacketHeader*>(pending.data.data())->sequence_number = sequence;
+        pending.last_sent = now;
+        pending.deadline = now + channel.rtt.rto;
         pending.retries = 0;
-        
-        {
-            std::lock_guard<std::mutex> lock(_reliable_mutex);
-            _pending_reliable[header.sequence_number] = std::move(pending);
-        }
+        pending.timer = _retransmit_timers.schedule(pending.deadline, retransmitKey(client.getId(), sequence));
+        wake = wakesTimerWait(pending.deadline);
+
+        transmit(pending.data.data(), size, client.getAddress(), &client);
     }
-    
-    _socket->sendTo(data, size, to);
+
+    if (wake && _running)
+        _shards.front()->waiter->wake();
 }
 
-void NetworkModule::sendAck(uint16_t sequence, const IAddress& dest)
+void NetworkModule::sendAck(uint16_t sequence, const Endpoint& dest, Server::Client* client)
 {
     Protocol::AckPacket ack;
     ack.header.sequence_number = 0;
     ack.ack_sequence = sequence;
     
-    _socket->sendTo(&ack, sizeof(ack), dest);
+    Metrics::ServerMetrics::instance().recordPacketOut(static_cast<uint8_t>(ack.header.type), sizeof(ack));
+    transmit(&ack, sizeof(ack), dest, client);
+}
+
+void NetworkModule::flushAck(Server::Client& client)
+{
+    uint16_t latest;
+    {
+        std::lock_guard<std::mutex> lock(_dedup_mutex);
+        auto& channel = client.reliableChannel();
+        if (!channel.ack_pending)
+            return;
+        latest = channel.acks.ack;
+    }
+    sendAck(latest, client.getAddress(), &client);
+}
+
+void NetworkModule::stampAcks(uint8_t* packet, Server::Client& client)
+{
+    auto& header = *reinterpret_cast<Protocol::PacketHeader*>(packet);
+    auto& channel = client.reliableChannel();
+
+    std::lock_guard<std::mutex> lock(_dedup_mutex);
+    if (!channel.acks.valid)
+        return;
+    header.setAcks(channel.acks.ack, channel.acks.bits);
+    channel.ack_pending = false;
+}
+
+void NetworkModule::beginBatch()
+{
+    if (t_outgoing.owner && t_outgoing.owner != this)
+        return;
+    t_outgoing.owner = this;
+}
+
+void NetworkModule::flush()
+{
+    if (t_outgoing.owner != this)
+        return;
+
+    // Frames hold their client, so closing them needs no table lock;
+    // flush() may run with _clients_mutex held.
+    auto& batch = t_outgoing;
+    for (size_t i = 0; i < batch.open_frames; ++i) {
+        closeFrame(i);
+        batch.frames[i].client.reset();
+    }
+    batch.open_frames = 0;
+    batch.frame_index.clear();
+
+    sendQueued();
+    t_outgoing.owner = nullptr;
+}
+
+void NetworkModule::transmit(const void* data, size_t size, const Endpoint& to, Server::Client* client)
+{
+    auto* bytes = static_cast<const uint8_t*>(data);
+
+    if (t_outgoing.owner != this) {
+        if (client) {
+            t_outgoing.stamped.assign(bytes, bytes + size);
+            stampAcks(t_outgoing.stamped.data(), *client);
+            data = t_outgoing.stamped.data();
+        }
+        _socket->sendTo(data, size, to);
+        Metrics::ServerMetrics::instance().recordSendCall();
+        return;
+    }
+
+    if (t_outgoing.spans.size() == SEND_BATCH)
+        sendQueued();
+
+    size_t offset = t_outgoing.bytes.size();
+    t_outgoing.spans.emplace_back(offset, size);
+    t_outgoing.bytes.insert(t_outgoing.bytes.end(), bytes, bytes + size);
+    t_outgoing.dests.push_back(to);
+    if (client)
+        stampAcks(t_outgoing.bytes.data() + offset, *client);
+}
+
+void NetworkModule::sendQueued()
+{
+    auto& batch = t_outgoing;
+    if (batch.spans.empty())
+        return;
+
+    // Pointers are taken only now: the byte buffer may have grown while
+    // packets were being queued.
+    batch.datagrams.clear();
+    for (size_t i = 0; i < batch.spans.size(); ++i) {
+        const auto& [offset, size] = batch.spans[i];
+        batch.datagrams.push_back(OutgoingDatagram{batch.bytes.data() + offset, size, batch.dests[i]});
+    }
+
+    _socket->sendBatch(batch.datagrams.data(), batch.datagrams.size());
+    Metrics::ServerMetrics::instance().recordSendCall();
+
+    batch.bytes.clear();
+    batch.spans.clear();
+    batch.dests.clear();
 }
 
-void NetworkModule::handleAck(uint16_t sequence, const std::shared_ptr<IAddress>&)
+void NetworkModule::handleAcks(Server::Client& client, uint16_t ack, uint32_t ack_bits)
 {
+    auto now = std::chrono::steady_clock::now();
     std::lock_guard<std::mutex> lock(_reliable_mutex);
-    _pending_reliable.erase(sequence);
+    auto& channel = client.reliableChannel();
+    forEachAcked(ack, ack_bits, [&](uint16_t sequence) {
+        auto it = channel.pending.find(sequence);
+        if (it == channel.pending.end())
+            return;
+        // Only the newest ack is timed, and only if it was sent once: an
+        // ack for a retransmitted packet could answer either copy.
+        if (sequence == ack && it->second.retries == 0)
+            recordRtt(channel, now - it->second.last_sent);
+        _retransmit_timers.cancel(it->second.timer);
+        channel.pending.erase(it);
+    });
+}
+
+bool NetworkModule::handlePong(Server::Client& client, uint16_t sequence)
+{
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(_reliable_mutex);
+    auto& channel = client.reliableChannel();
+    if (!channel.ping_outstanding || channel.ping_sequence != sequence)
+        return false;
+    channel.ping_outstanding = false;
+    recordRtt(channel, now - channel.ping_sent);
+    return true;
+}
+
+void NetworkModule::recordRtt(ReliableChannel& channel, std::chrono::steady_clock::duration rtt)
+{
+    auto sample = std::chrono::duration_cast<RttEstimator::Duration>(rtt);
+    channel.rtt.sample(sample);
+
+    auto& metrics = Metrics::ServerMetrics::instance();
+    metrics.peerRtt().observe(static_cast<uint64_t>(sample.count()));
+    metrics.retransmitTimeout().observe(static_cast<uint64_t>(channel.rtt.rto.count()));
+}
+
+void NetworkModule::pingClients()
+{
+    auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> clientsLock(_clients_mutex);
+    SendBatch pings(*this);
+
+    for (const auto& [id, client] : _clients_by_id) {
+        if (client->getState() != Server::ClientState::CONNECTED)
+            continue;
+
+        Protocol::PacketHeader ping;
+        ping.type = Protocol::PacketType::PING;
+        {
+            std::lock_guard<std::mutex> lock(_reliable_mutex);
+            auto& channel = client->reliableChannel();
+            ping.sequence_number = ++channel.ping_sequence;
+            channel.ping_outstanding = true;
+            channel.ping_sent = now;
+        }
+
+        Metrics::ServerMetrics::instance().recordPacketOut(static_cast<uint8_t>(ping.type), sizeof(ping));
+        transmit(&ping, sizeof(ping), client->getAddress(), client.get());
+    }
 }
 
 void NetworkModule::sendToClientRaw(uint32_t client_id, const void* data, size_t size)
@@ -258,29 +833,51 @@ void NetworkModule::sendToClientRaw(uint32_t client_id, const void* data, size_t
     if (it == _clients_by_id.end())
         return;
     
-    const auto& header = *reinterpret_cast<const Protocol::PacketHeader*>(data);
-    sendRawPacket(data, size, *it->second->getAddress(), header.isReliable());
+    sendRawPacket(data, size, it->second->getAddress(), it->second);
 }
 
-void NetworkModule::sendToAddressRaw(const std::shared_ptr<IAddress>& addr, 
+void NetworkModule::sendOrderedRaw(uint32_t client_id, const void* data, size_t size)
+{
+    std::lock_guard<std::mutex> lock(_clients_mutex);
+
+    auto it = _clients_by_id.find(client_id);
+    if (it == _clients_by_id.end())
+        return;
+
+    Protocol::OrderedHeader header;
+    {
+        std::lock_guard<std::mutex> reliableLock(_reliable_mutex);
+        header.order_sequence = it->second->reliableChannel().ordered.nextSendSequence();
+    }
+
+    // The wrapper is what gets acked and retransmitted.
+    auto& message = t_outgoing.ordered;
+    message.resize(sizeof(header) + size);
+    std::memcpy(message.data(), &header, sizeof(header));
+    std::memcpy(message.data() + sizeof(header), data, size);
+    reinterpret_cast<Protocol::PacketHeader*>(message.data() + sizeof(header))->setReliable(false);
+
+    sendRawPacket(message.data(), message.size(), it->second->getAddress(), it->second);
+}
+
+void NetworkModule::sendToAddressRaw(const Endpoint& addr,
                                       const void* data, 
                                       size_t size)
 {
-    const auto& header = *reinterpret_cast<const Protocol::PacketHeader*>(data);
-    sendRawPacket(data, size, *addr, header.isReliable());
+    std::lock_guard<std::mutex> lock(_clients_mutex);
+
+    auto it = _clients_by_addr.find(addr);
+    sendRawPacket(data, size, addr, it != _clients_by_addr.end() ? it->second : nullptr);
 }
 
 void NetworkModule::broadcastRaw(const void* data, size_t size, uint32_t exclude_id)
 {
     std::lock_guard<std::mutex> lock(_clients_mutex);
     
-    const auto& header = *reinterpret_cast<const Protocol::PacketHeader*>(data);
-    bool reliable = header.isReliable();
-    
-    for (const auto& [addr, client] : _clients_by_addr) {
+    for (const auto& [key, client] : _clients_by_addr) {
         if (client->getId() != exclude_id && 
             client->getState() == Server::ClientState::CONNECTED) {
-            sendRawPacket(data, size, *addr, reliable);
+            sendRawPacket(data, size, client->getAddress(), client);
         }
     }
 }
@@ -311,13 +908,16 @@ void NetworkModule::disconnectClientUnsafe(uint32_t client_id)
     
     auto client = it->second;
     
+    Endpoint key = client->getAddress();
+    _clients_by_addr.erase(key);
+    _clients_by_id.erase(client_id);
+
     {
-        std::lock_guard<std::mutex> slot_lock(_slots_mutex);
-        _player_slots[client->getPlayerSlot()] = false;
+        std::lock_guard<std::mutex> lock(_reliable_mutex);
+        for (auto& [sequence, pending] : client->reliableChannel().pending)
+            _retransmit_timers.cancel(pending.timer);
+        client->reliableChannel().pending.clear();
     }
-    
-    _clients_by_addr.erase(client->getAddress());
-    _clients_by_id.erase(client_id);
 }
 
 void NetworkModule::disconnectClient(uint32_t client_id)
@@ -326,36 +926,29 @@ void NetworkModule::disconnectClient(uint32_t client_id)
     disconnectClientUnsafe(client_id);
 }
 
-uint32_t NetworkModule::registerClient(const std::shared_ptr<IAddress>& addr,
-                                        const std::string& name,
-                                        uint8_t slot)
+ClientRegistration NetworkModule::registerClient(const Endpoint& addr,
+                                                 const std::string& name,
+                                                 uint32_t room_id,
+                                                 uint8_t slot)
 {
     std::lock_guard<std::mutex> lock(_clients_mutex);
     
     auto it = _clients_by_addr.find(addr);
     if (it != _clients_by_addr.end())
-        return it->second->getId();
+        return ClientRegistration{it->second->getId(), false, it->second->getRoomId()};
 
-    uint32_t id = slot + 1;
-    
-    auto existing_id = _clients_by_id.find(id);
-    if (existing_id != _clients_by_id.end()) {
-        disconnectClientUnsafe(id);
-    }
+    uint32_t id = _next_client_id++;
+    if (id == 0)
+        id = _next_client_id++;
     
-    auto client = std::make_shared<Server::Client>(id, addr, name);
+    auto client = std::make_shared<Server::Client>(id, addr, name, room_id);
     client->setPlayerSlot(slot);
     client->setState(Server::ClientState::CONNECTED);
     
     _clients_by_addr[addr] = client;
     _clients_by_id[id] = client;
     
-    {
-        std::lock_guard<std::mutex> slot_lock(_slots_mutex);
-        _player_slots[slot] = true;
-    }
-    
-    return id;
+    return ClientRegistration{id, true, room_id};
 }
 
 void NetworkModule::unregisterClient(uint32_t client_id)
@@ -373,7 +966,7 @@ std::shared_ptr<Server::Client> NetworkModule::getClient(uint32_t client_id) con
     return nullptr;
 }
 
-std::shared_ptr<Server::Client> NetworkModule::getClientByAddress(const std::shared_ptr<IAddress>& addr) const
+std::shared_ptr<Server::Client> NetworkModule::getClientByAddress(const Endpoint& addr) const
 {
     std::lock_guard<std::mutex> lock(_clients_mutex);
     
@@ -383,26 +976,6 @@ std::shared_ptr<Server::Client> NetworkModule::getClientByAddress(const std::sha
     return nullptr;
 }
 
-bool NetworkModule::hasAvailableSlot() const
-{
-    std::lock_guard<std::mutex> lock(_slots_mutex);
-    for (int i = 0; i < 4; i++) {
-        if (!_player_slots[i])
-            return true;
-    }
-    return false;
-}
-
-uint8_t NetworkModule::findFreePlayerSlot() const
-{
-    std::lock_guard<std::mutex> lock(_slots_mutex);
-    for (uint8_t i = 0; i < 4; i++) {
-        if (!_player_slots[i])
-            return i;
-    }
-    return 255;
-}
-
 std::vector<uint32_t> NetworkModule::checkTimeouts(std::chrono::seconds timeout)
 {
     std::lock_guard<std::mutex> lock(_clients_mutex);
@@ -410,7 +983,9 @@ std::vector<uint32_t> NetworkModule::checkTimeouts(std::chrono::seconds timeout)
     std::vector<uint32_t> timed_out;
     
     for (const auto& [id, client] : _clients_by_id) {
-        if (client->isTimedOut(timeout)) {
+        if (client->getState() == Server::ClientState::CONNECTED &&
+            client->isTimedOut(timeout)) {
+            client->setState(Server::ClientState::DISCONNECTED);
             timed_out.push_back(id);
         }
     }
@@ -0,0 +1,847 @@
+#include "Room.hpp"
+#include "Client.hpp"
+#include "network/BitStream.hpp"
+#include "network/ISocket.hpp"
+#include "network/SnapshotCodec.hpp"
+#include "metrics/Profiler.hpp"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <unordered_set>
+#include <cmath>
+
+namespace RType::Server {
+
+namespace {
+    std::chrono::steady_clock::rep nowTicks()
+    {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    // How fast an entity's snapshot priority grows while it goes unsent.
+    // Players and the boss dominate; other entities fade with distance
+    // from the receiving player, and entities the client has never seen
+    // get a boost so spawns show up promptly.
+    float snapshotWeight(const EntitySnapshot& snap, const EntitySnapshot* viewer, bool isNew)
+    {
+        constexpr float NEAR_DISTANCE = 400.f;
+
+        float weight;
+        switch (Protocol::fromEntityTypeId(snap.entity_type)) {
+            case Protocol::EntityType::PLAYER:
+            case Protocol::EntityType::BOSS:
+                return 100.f;
+            case Protocol::EntityType::ENEMY_BASIC:
+            case Protocol::EntityType::ENEMY_FASTSHOOTER:
+            case Protocol::EntityType::ENEMY_BOMBER:
+                weight = 4.f;
+                break;
+            case Protocol::EntityType::PROJECTILE_ENEMY:
+                weight = 2.f;
+                break;
+            default:
+                weight = 1.f;
+                break;
+        }
+
+        if (viewer) {
+            float distance = std::hypot(snap.pos_x - viewer->pos_x, snap.pos_y - viewer->pos_y);
+            weight /= 1.f + distance / NEAR_DISTANCE;
+        }
+        return isNew ? weight * 4.f : weight;
+    }
+
+    // Despawns are rare and cheap, and a client that misses one keeps a
+    // ghost entity, so they go ahead of everything but players and bosses.
+    constexpr float REMOVAL_WEIGHT = 50.f;
+
+    // Quantization: Convert float32 to int16 (saves ~50% on numeric data)
+    Protocol::QuantizedEntityData quantize(const EntitySnapshot& snap)
+    {
+        Protocol::QuantizedEntityData qdata;
+        qdata.entity_id = snap.entity_id;
+        qdata.pos_x = Protocol::quantizePosition(snap.pos_x);
+        qdata.pos_y = Protocol::quantizePosition(snap.pos_y);
+        qdata.vel_x = Protocol::quantizeVelocity(snap.vel_x);
+        qdata.vel_y = Protocol::quantizeVelocity(snap.vel_y);
+        qdata.hp_current = Protocol::quantizeHP(snap.hp_current);
+        qdata.hp_max = Protocol::quantizeHP(snap.hp_max);
+        qdata.entity_type = snap.entity_type;
+        qdata.player_slot = snap.player_slot;
+        return qdata;
+    }
+
+    // The fields of state a client holding baseline needs. Position drifts
+    // up to 0.5 units and HP drifts of 1 are tolerated; they are measured
+    // against the baseline, so they never accumulate.
+    uint8_t changeMask(const Protocol::QuantizedEntityData& state, const Protocol::QuantizedEntityData& baseline)
+    {
+        constexpr int POS_EPSILON = 5;
+        constexpr int HP_EPSILON = 1;
+
+        uint8_t mask = 0;
+        if (std::abs(state.pos_x - baseline.pos_x) > POS_EPSILON ||
+            std::abs(state.pos_y - baseline.pos_y) > POS_EPSILON) {
+            mask |= Protocol::CHANGED_POSITION;
+        }
+        if (state.vel_x != baseline.vel_x || state.vel_y != baseline.vel_y) {
+            mask |= Protocol::CHANGED_VELOCITY;
+        }
+        if (std::abs(state.hp_current - baseline.hp_current) > HP_EPSILON ||
+            std::abs(state.hp_max - baseline.hp_max) > HP_EPSILON) {
+            mask |= Protocol::CHANGED_HP;
+        }
+        if (state.entity_type != baseline.entity_type) {
+            mask |= Protocol::CHANGED_TYPE;
+        }
+        if (state.player_slot != baseline.player_slot) {
+            mask |= Protocol::CHANGED_SLOT;
+        }
+        return mask;
+    }
+}
+
+Room::Room(uint32_t id, Network::INetworkModule& network)
+    : _id(id)
+    , _network(network)
+    , _inbox(INBOX_CAPACITY)
+    , _memberCount(0)
+    , _lastActivity(nowTicks())
+    , _slots{}
+    , _sequenceCounter(1)
+    , _timeScale(100)
+    , _snapshotAccumulator(0.f)
+    , _snapshotTick(0)
+    , _gameStarted(false)
+    , _gameOver(false)
+{
+    _game.init();
+}
+
+bool Room::enqueue(Network::ReceivedMessage msg)
+{
+    _lastActivity = nowTicks();
+    auto type = static_cast<Protocol::PacketType>(msg.packet_type);
+    if (type == Protocol::PacketType::CONNECT_REQUEST || type == Protocol::PacketType::DISCONNECT) {
+        std::lock_guard<std::mutex> lock(_controlMutex);
+        _control.push_back(std::move(msg));
+        return true;
+    }
+    if (!_inbox.tryPush(std::move(msg))) {
+        Metrics::ServerMetrics::instance().recordInboxDropped();
+        return false;
+    }
+    return true;
+}
+
+size_t Room::getEntityCount() const
+{
+    auto frame = _game.latestFrame();
+    return frame ? frame->entities.size() : 0;
+}
+
+bool Room::isIdle(std::chrono::seconds grace) const
+{
+    if (_memberCount != 0) {
+        return false;
+    }
+    auto last = std::chrono::steady_clock::time_point(
+        std::chrono::steady_clock::duration(_lastActivity.load()));
+    return std::chrono::steady_clock::now() - last > grace;
+}
+
+void Room::tick(float dt)
+{
+    RTYPE_PROFILE_TICK(_id);
+
+    {
+        RTYPE_PROFILE_SCOPE(Metrics::Phase::INBOX);
+
+        {
+            std::lock_guard<std::mutex> lock(_controlMutex);
+            _controlDrain.swap(_control);
+        }
+        for (const auto& control : _controlDrain) {
+            handleMessage(control);
+        }
+        _controlDrain.clear();
+
+        // Only drain what was queued when the tick started so a flood of
+        // input cannot keep the room from simulating.
+        size_t pending = _inbox.size();
+        Metrics::ServerMetrics::instance().recordInboxDepth(pending);
+
+        Network::ReceivedMessage msg;
+        while (pending-- > 0 && _inbox.tryPop(msg)) {
+            handleMessage(msg);
+        }
+    }
+
+    if (!_gameStarted || _gameOver) {
+        return;
+    }
+
+    _game.update(dt);
+    auto events = _game.pollEvents();
+    for (const auto& event : events) {
+        broadcastEvent(event);
+    }
+
+    auto networkEvents = _game.pollNetworkEvents();
+    for (const auto& netEvent : networkEvents) {
+        broadcastNetworkEvent(netEvent);
+
+        if (netEvent.event_type == Protocol::GameEventType::GAME_OVER) {
+            std::cout << "[Room " << _id << "] GAME_OVER event detected, triggering final game over..." << std::endl;
+            _gameOver = true;
+            _gameStarted = false;
+            broadcastGameOver();
+        }
+    }
+
+    if (_game.isGameOver() && !_gameOver) {
+        std::cout << "[Room " << _id << "] GameModule reports game over! Broadcasting..." << std::endl;
+        _gameOver = true;
+        _gameStarted = false;
+        broadcastGameOver();
+    }
+
+    if (_game.areAllPlayersDead() && !_gameOver) {
+        std::cout << "[Room " << _id << "] All players dead! Broadcasting game over..." << std::endl;
+        _gameOver = true;
+        _gameStarted = false;
+        broadcastGameOver();
+    }
+
+    _snapshotAccumulator += dt;
+    if (_snapshotAccumulator >= SNAPSHOT_DT) {
+        RTYPE_PROFILE_SCOPE(Metrics::Phase::SNAPSHOT);
+        broadcastGameState();
+        broadcastScores();
+        _snapshotAccumulator = 0.f;
+    }
+}
+
+void Room::handleMessage(const Network::ReceivedMessage& msg)
+{
+    auto type = static_cast<Protocol::PacketType>(msg.packet_type);
+
+    switch (type) {
+        case Protocol::PacketType::CONNECT_REQUEST:
+            if (msg.payload_size >= sizeof(Protocol::ConnectRequest)) {
+                handleConnectRequest(msg);
+            }
+            break;
+
+        case Protocol::PacketType::DISCONNECT:
+            if (msg.payload_size >= sizeof(Protocol::DisconnectPacket)) {
+                handleDisconnect(msg);
+            }
+            break;
+
+        case Protocol::PacketType::PLAYER_INPUT:
+            if (msg.payload_size >= sizeof(Protocol::PlayerInput)) {
+                handlePlayerInput(msg);
+            }
+            break;
+
+        case Protocol::PacketType::READY_TO_PLAY:
+            if (msg.payload_size >= sizeof(Protocol::ReadyToPlay)) {
+                handleReadyToPlay(msg);
+            }
+            break;
+
+        case Protocol::PacketType::GAME_ON:
+            if (msg.payload_size >= sizeof(Protocol::GameOn)) {
+                handleGameOn(msg);
+            }
+            break;
+
+        case Protocol::PacketType::SNAPSHOT_ACK:
+            if (msg.payload_size >= Protocol::SnapshotAck::PREFIX_SIZE) {
+                handleSnapshotAck(msg);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+uint8_t Room::findFreeSlot() const
+{
+    for (uint8_t i = 0; i < MAX_PLAYERS; i++) {
+        if (!_slots[i])
+            return i;
+    }
+    return 255;
+}
+
+void Room::handleConnectRequest(const Network::ReceivedMessage& msg)
+{
+    Protocol::ConnectRequest request;
+    std::memcpy(&request, msg.payload.data(), sizeof(Protocol::ConnectRequest));
+
+    Protocol::ConnectResponse response;
+    response.header.sequence_number = _sequenceCounter++;
+    response.room_id = _id;
+    std::strncpy(response.server_version, SERVER_VERSION,
+                 sizeof(response.server_version) - 1);
+
+    auto existing_client = _network.getClientByAddress(msg.source_addr);
+    if (existing_client) {
+        auto it = _members.find(existing_client->getId());
+        if (it != _members.end()) {
+            response.status = Protocol::ConnectionStatus::ACCEPTED;
+            response.client_id = it->second.player_id;
+            response.assigned_player_slot = it->second.slot;
+            if (it->second.compressSnapshots) {
+                response.capabilities = Protocol::CAPABILITY_SNAPSHOT_COMPRESSION;
+            }
+        } else {
+            response.status = Protocol::ConnectionStatus::REJECTED_NO_ROOM;
+        }
+
+        _network.sendToAddress(msg.source_addr, response);
+        return;
+    }
+
+    uint8_t slot = findFreeSlot();
+    if (slot == 255) {
+        response.status = Protocol::ConnectionStatus::REJECTED_FULL;
+        response.client_id = 0;
+        _network.sendToAddress(msg.source_addr, response);
+        return;
+    }
+
+    std::string player_name(request.player_name,
+                            strnlen(request.player_name, sizeof(request.player_name)));
+
+    // Another room may have registered this address since the lookup
+    // above; the entry is then theirs and taking a slot would leave a
+    // member that never hears from its client.
+    auto registration = _network.registerClient(msg.source_addr, player_name, _id, slot);
+    if (!registration.created || registration.room_id != _id) {
+        response.status = Protocol::ConnectionStatus::REJECTED_NO_ROOM;
+        _network.sendToAddress(msg.source_addr, response);
+        return;
+    }
+    uint32_t connection_id = registration.client_id;
+    uint32_t player_id = slot + 1;
+
+    Member member;
+    member.player_id = player_id;
+    member.slot = slot;
+    member.name = player_name;
+    member.compressSnapshots = (request.capabilities & Protocol::CAPABILITY_SNAPSHOT_COMPRESSION) != 0;
+    _members[connection_id] = member;
+    _slots[slot] = true;
+    _memberCount = _members.size();
+
+    response.status = Protocol::ConnectionStatus::ACCEPTED;
+    response.client_id = player_id;
+    response.assigned_player_slot = slot;
+    if (member.compressSnapshots) {
+        response.capabilities = Protocol::CAPABILITY_SNAPSHOT_COMPRESSION;
+    }
+
+    _network.sendToAddress(msg.source_addr, response);
+
+    std::cout << "[Room " << _id << "] Client connected: " << player_name
+              << " [" << msg.source_addr.toString() << "] ID=" << player_id
+              << " Conn=" << connection_id
+              << " Slot=" << (int)slot << std::endl;
+
+    float spawnX = 100.f;
+    float spawnY = 150.f + (slot * 120.f);
+    _game.spawnPlayer(player_id, spawnX, spawnY, slot);
+
+    Protocol::DisconnectPacket notify;
+    notify.header.sequence_number = _sequenceCounter++;
+    notify.client_id = player_id;
+    notify.reason = 0;
+    broadcast(notify, connection_id);
+
+    broadcastLobbyStatus();
+}
+
+void Room::handleDisconnect(const Network::ReceivedMessage& msg)
+{
+    Protocol::DisconnectPacket packet;
+    std::memcpy(&packet, msg.payload.data(), sizeof(Protocol::DisconnectPacket));
+
+    auto it = _members.find(msg.client_id);
+    if (it == _members.end()) {
+        return;
+    }
+
+    std::cout << "[Room " << _id << "] Client disconnected: " << it->second.name
+              << " [" << msg.source_addr.toString() << "]"
+              << (packet.reason == 1 ? " (timeout)" : "") << std::endl;
+
+    uint32_t player_id = it->second.player_id;
+    removeMember(msg.client_id);
+
+    packet.header.sequence_number = _sequenceCounter++;
+    packet.client_id = player_id;
+    broadcast(packet);
+    broadcastLobbyStatus();
+}
+
+void Room::removeMember(uint32_t connection_id)
+{
+    auto it = _members.find(connection_id);
+    if (it == _members.end()) {
+        return;
+    }
+
+    _game.removePlayer(it->second.player_id);
+    _slots[it->second.slot] = false;
+    _baselinesByClient.erase(connection_id);
+    _prioritiesByClient.erase(connection_id);
+    _members.erase(it);
+    _memberCount = _members.size();
+    _network.disconnectClient(connection_id);
+
+    resetIfEmpty();
+}
+
+void Room::resetIfEmpty()
+{
+    if (_members.empty() && (_gameStarted || _gameOver)) {
+        _gameStarted = false;
+        _gameOver = false;
+        _game.init();
+    }
+}
+
+void Room::handlePlayerInput(const Network::ReceivedMessage& msg)
+{
+    if (!_gameStarted) {
+        return;
+    }
+
+    auto it = _members.find(msg.client_id);
+    if (it == _members.end()) {
+        return;
+    }
+
+    Protocol::PlayerInput input;
+    std::memcpy(&input, msg.payload.data(), sizeof(Protocol::PlayerInput));
+
+    // ============================================================================
+    // RATE LIMITING - Track #2
+    // Prevents input spam (max 60 inputs/sec per client)
+    // Protects against malicious clients flooding the server
+    // ============================================================================
+    auto now = std::chrono::steady_clock::now();
+    auto& lastTime = it->second.last_input;
+
+    if (lastTime.time_since_epoch().count() > 0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastTime);
+        if (elapsed < MIN_INPUT_INTERVAL) {
+            return;
+        }
+    }
+
+    lastTime = now;
+
+    _game.processInput(it->second.player_id, input.input_flags);
+}
+
+void Room::handleReadyToPlay(const Network::ReceivedMessage& msg)
+{
+    Protocol::ReadyToPlay packet;
+    std::memcpy(&packet, msg.payload.data(), sizeof(Protocol::ReadyToPlay));
+
+    auto it = _members.find(msg.client_id);
+    if (it == _members.end()) {
+        return;
+    }
+
+    it->second.ready = (packet.ready != 0);
+    broadcastLobbyStatus();
+
+    if (!_gameStarted && !_gameOver && areAllPlayersReady()) {
+        _gameStarted = true;
+
+        Protocol::GameOn start;
+        start.header.sequence_number = _sequenceCounter++;
+        start.client_id = it->second.player_id;
+        broadcastOrdered(start);
+
+        broadcastLobbyStatus();
+    }
+}
+
+void Room::handleGameOn(const Network::ReceivedMessage& msg)
+{
+    if (_members.find(msg.client_id) == _members.end()) {
+        return;
+    }
+
+    Protocol::GameOn packet;
+    std::memcpy(&packet, msg.payload.data(), sizeof(Protocol::GameOn));
+
+    _gameStarted = true;
+    packet.header.sequence_number = _sequenceCounter++;
+    broadcastOrdered(packet);
+    broadcastLobbyStatus();
+}
+
+bool Room::areAllPlayersReady() const
+{
+    if (_members.empty()) {
+        return false;
+    }
+
+    for (const auto& [connection_id, member] : _members) {
+        if (!member.ready) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Room::broadcastLobbyStatus()
+{
+    Protocol::LobbyStatus status;
+    status.header.sequence_number = _sequenceCounter++;
+    status.max_players = MAX_PLAYERS;
+    status.players_connected = static_cast<uint8_t>(_members.size());
+    status.players_ready = 0;
+    status.ready_mask = 0;
+    status.game_started = _gameStarted ? 1 : 0;
+
+    for (const auto& [connection_id, member] : _members) {
+        if (member.ready) {
+            status.players_ready++;
+            if (member.slot < 8) {
+                status.ready_mask |= static_cast<uint8_t>(1u << member.slot);
+            }
+        }
+    }
+
+    broadcast(status);
+}
+
+void Room::broadcastGameState()
+{
+    if (_members.empty()) {
+        return;
+    }
+
+    auto frame = _game.publishFrame();
+    const auto& snapshots = frame->entities;
+
+    // ============================================================================
+    // ADVANCED NETWORKING - Track #2
+    // Combines: Delta Compression + Quantization + Packet Batching
+    // Bandwidth reduction: ~80% total
+    // Each client gets at most snapshotBudgetBytes() per snapshot, filled by
+    // accumulated priority; whatever does not fit waits for a later one.
+    // ============================================================================
+
+    std::unordered_set<uint32_t> currentEntityIds;
+    std::vector<Protocol::QuantizedEntityData> quantized;
+    quantized.reserve(snapshots.size());
+    for (const auto& snap : snapshots) {
+        currentEntityIds.insert(snap.entity_id);
+        quantized.push_back(quantize(snap));
+    }
+
+    uint32_t tick = ++_snapshotTick;
+    size_t deferred = 0;
+    std::vector<uint32_t> removals;
+
+    // entity_count, time_scale and tick, bit-packed ahead of the entries.
+    Protocol::BatchedEntityUpdate empty;
+    Network::BitWriter prefix(nullptr, SIZE_MAX);
+    empty.serialize(prefix);
+    const size_t budgetBits = (snapshotBudgetBytes() - sizeof(Protocol::PacketHeader)) * 8 - prefix.bitsWritten();
+
+    for (const auto& [client_id, member] : _members) {
+        // Everything is compared against what this client acknowledged,
+        // not what it was last sent: a lost snapshot is repeated until an
+        // ack for a later one confirms the client caught up.
+        auto& baseline = _baselinesByClient[client_id];
+        auto& priorities = _prioritiesByClient[client_id];
+        priorities.beginRound();
+
+        const EntitySnapshot* viewer = nullptr;
+        for (const auto& snap : snapshots) {
+            if (snap.entity_type == 0 && snap.player_slot == member.slot) {
+                viewer = &snap;
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < snapshots.size(); ++i) {
+            const auto& snap = snapshots[i];
+            auto known = baseline.find(snap.entity_id);
+            if (!known.baseline || known.pending || changeMask(quantized[i], *known.baseline) != 0) {
+                priorities.add(snap.entity_id, snapshotWeight(snap, viewer, known.baseline == nullptr), i);
+            }
+        }
+
+        // Entities the client may still hold that no longer exist.
+        removals.clear();
+        baseline.forEachKnown([&](uint32_t id) {
+            if (currentEntityIds.count(id) == 0) {
+                removals.push_back(id);
+            }
+        });
+        for (size_t r = 0; r < removals.size(); ++r) {
+            priorities.add(removals[r], REMOVAL_WEIGHT, snapshots.size() + r);
+        }
+
+        Protocol::BatchedEntityUpdate batch;
+        batch.header.sequence_number = _sequenceCounter++;
+        batch.entity_count = 0;
+        batch.time_scale = _timeScale;
+        batch.tick = tick;
+        baseline.begin(tick);
+
+        size_t budget = budgetBits;
+        const auto& ranked = priorities.ranked();
+        size_t sent = 0;
+
+        for (const auto& candidate : ranked) {
+            if (batch.entity_count >= Protocol::BatchedEntityUpdate::MAX_ENTITIES) {
+                break;
+            }
+
+            Protocol::EntityDeltaData& delta = batch.entities[batch.entity_count];
+            delta = Protocol::EntityDeltaData();
+            delta.entity_id = candidate.id;
+            // What the client will hold once it applies the entry.
+            Protocol::QuantizedEntityData held;
+
+            if (candidate.index >= snapshots.size()) {
+                delta.change_mask = Protocol::ENTITY_REMOVED;
+            } else {
+                const auto& state = quantized[candidate.index];
+                auto known = baseline.find(candidate.id);
+                // Only fields that moved away from the baseline go out, as
+                // long as the client is sure to still hold that baseline.
+                if (known.baseline && (!known.pending
+                                       || tick - known.baselineTick < Protocol::EntityDeltaData::HISTORY)) {
+                    held = *known.baseline;
+                    delta.change_mask = changeMask(state, held);
+                    delta.baseline_age = tick - known.baselineTick;
+                } else {
+                    delta.change_mask = Protocol::CHANGED_ALL;
+                }
+                delta.pos_x = state.pos_x;
+                delta.pos_y = state.pos_y;
+                delta.vel_x = state.vel_x;
+                delta.vel_y = state.vel_y;
+                delta.hp_current = state.hp_current;
+                delta.hp_max = state.hp_max;
+                delta.entity_type = state.entity_type;
+                delta.player_slot = state.player_slot;
+                held.entity_id = candidate.id;
+                Protocol::applyEntityDelta(held, delta);
+            }
+
+            // Entries differ in size, so a smaller one may still fit.
+            Network::BitWriter measure(nullptr, SIZE_MAX);
+            delta.serialize(measure);
+            if (measure.bitsWritten() > budget) {
+                continue;
+            }
+            budget -= measure.bitsWritten();
+
+            if (delta.change_mask & Protocol::ENTITY_REMOVED) {
+                baseline.removed(candidate.id);
+            } else {
+                baseline.sent(candidate.id, held);
+            }
+            batch.entity_count++;
+            sent++;
+            priorities.sent(candidate.id);
+        }
+
+        // Sent even when empty, so the client keeps its tick and the time
+        // scale current.
+        Network::EncodedPacket<sizeof(Protocol::BatchedEntityUpdate)> encoded;
+        if (Network::encode(batch, encoded)) {
+            sendSnapshot(client_id, member, encoded);
+        }
+        deferred += ranked.size() - sent;
+
+        priorities.retain([&](uint32_t id) {
+            return currentEntityIds.count(id) != 0
+                || std::find(removals.begin(), removals.end(), id) != removals.end();
+        });
+    }
+
+    if (deferred > 0) {
+        Metrics::ServerMetrics::instance().recordSnapshotDeferred(deferred);
+    }
+}
+
+// ENTITY_UPDATE wire bytes per client per snapshot: the most that still
+// fits one bundle entry within the MTU, so a snapshot is never fragmented
+// (about 23 KB/s at 20 Hz with the default 1200-byte MTU).
+size_t Room::snapshotBudgetBytes() const
+{
+    return _network.getMtu() - sizeof(Protocol::BundleHeader) - Protocol::BundleHeader::ENTRY_PREFIX;
+}
+
+void Room::sendSnapshot(uint32_t client_id, const Member& member,
+                        const Network::EncodedPacket<sizeof(Protocol::BatchedEntityUpdate)>& encoded)
+{
+    if (!member.compressSnapshots) {
+        _network.sendToClient(client_id, encoded);
+        return;
+    }
+
+    // Each datagram is compressed on its own, so a lost one costs nothing
+    // but itself; when the codec cannot shrink it, it goes out as it is.
+    constexpr size_t HEADER_BYTES = sizeof(Protocol::PacketHeader);
+    Network::EncodedPacket<sizeof(Protocol::BatchedEntityUpdate)> compressed;
+    size_t body = Network::compressBody(encoded, HEADER_BYTES, compressed);
+    Metrics::ServerMetrics::instance().recordSnapshotCompression(encoded.size - HEADER_BYTES, body);
+    if (body == 0) {
+        _network.sendToClient(client_id, encoded);
+        return;
+    }
+
+    Protocol::PacketHeader header;
+    std::memcpy(&header, compressed.bytes, HEADER_BYTES);
+    header.flags |= static_cast<uint8_t>(Protocol::ReliabilityFlag::COMPRESSED);
+    std::memcpy(compressed.bytes, &header, HEADER_BYTES);
+    _network.sendToClient(client_id, compressed);
+}
+
+void Room::handleSnapshotAck(const Network::ReceivedMessage& msg)
+{
+    auto it = _baselinesByClient.find(msg.client_id);
+    if (it == _baselinesByClient.end()) {
+        return;
+    }
+
+    Protocol::SnapshotAck ack;
+    std::memcpy(&ack, msg.payload.data(), std::min(msg.payload_size, sizeof(Protocol::SnapshotAck)));
+    it->second.acknowledge(ack.tick);
+
+    size_t listed = (msg.payload_size - Protocol::SnapshotAck::PREFIX_SIZE) / sizeof(uint32_t);
+    size_t count = std::min<size_t>({ack.resync_count, listed, Protocol::SnapshotAck::MAX_RESYNC});
+    for (size_t i = 0; i < count; ++i) {
+        it->second.resync(ack.resync_ids[i]);
+    }
+}
+
+void Room::broadcastScores()
+{
+    Protocol::ScoreUpdate packet;
+    packet.header.sequence_number = _sequenceCounter++;
+
+    for (const auto& [connection_id, member] : _members) {
+        if (packet.num_players >= 4)
+            break;
+        Protocol::PlayerScoreEntry& entry = packet.players[packet.num_players++];
+        entry.client_id = member.player_id;
+        entry.score = _game.getPlayerScore(member.player_id);
+        entry.enemies_killed = _game.getPlayerKills(member.player_id);
+    }
+
+    RType::Network::EncodedPacket<sizeof(packet) + 16> encoded;
+    if (!RType::Network::encode(packet, encoded)) {
+        std::cerr << "[Room " << _id << "] Failed to encode SCORE_UPDATE" << std::endl;
+        return;
+    }
+    broadcast(encoded);
+}
+
+void Room::broadcastGameOver()
+{
+    Protocol::GameOver packet;
+    packet.header.sequence_number = _sequenceCounter++;
+
+    auto finalScores = _game.getFinalScores();
+    packet.num_players = static_cast<uint8_t>((std::min)(finalScores.size(), static_cast<size_t>(4)));
+
+    for (size_t i = 0; i < packet.num_players; ++i) {
+        packet.players[i] = finalScores[i];
+    }
+
+    std::cout << "[Room " << _id << "] Broadcasting GAME_OVER packet with " << (int)packet.num_players << " players" << std::endl;
+
+    RType::Network::EncodedPacket<sizeof(packet) + 16> encoded;
+    if (!RType::Network::encode(packet, encoded)) {
+        std::cerr << "[Room " << _id << "] Failed to encode GAME_OVER" << std::endl;
+        return;
+    }
+    broadcastOrdered(encoded);
+}
+
+void Room::broadcastEvent(const LocalGameEvent& event)
+{
+    switch (event.type) {
+        case EventType::ENTITY_SPAWNED: {
+            Protocol::EntitySpawn packet;
+            packet.header.sequence_number = _sequenceCounter++;
+            packet.entity_id = event.entity_id;
+            packet.entity_type = event.entity_type;
+            packet.pos_x = event.pos_x;
+            packet.pos_y = event.pos_y;
+            broadcast(packet);
+            break;
+        }
+
+        case EventType::ENTITY_DESTROYED: {
+            Protocol::EntityDestroy packet;
+            packet.header.sequence_number = _sequenceCounter++;
+            packet.entity_id = event.entity_id;
+            packet.killer_id = event.related_id;
+            packet.reason = event.extra_data;
+            broadcast(packet);
+            break;
+        }
+
+        case EventType::ENTITY_FIRED: {
+            Protocol::EntityFire packet;
+            packet.header.sequence_number = _sequenceCounter++;
+            packet.shooter_id = event.related_id;
+            packet.projectile_id = event.entity_id;
+            packet.pos_x = event.pos_x;
+            packet.pos_y = event.pos_y;
+            packet.projectile_type = event.extra_data;
+            broadcast(packet);
+            break;
+        }
+
+        case EventType::PLAYER_DIED: {
+            Protocol::PlayerDeath packet;
+            packet.header.sequence_number = _sequenceCounter++;
+            packet.player_id = event.entity_id;
+            packet.killer_id = event.related_id;
+            packet.death_type = event.extra_data;
+            broadcastOrdered(packet);
+            break;
+        }
+    }
+}
+
+void Room::broadcastNetworkEvent(const Protocol::GameEvent& event)
+{
+    Protocol::GameEvent packet = event;
+    packet.header.sequence_number = _sequenceCounter++;
+
+    if (event.event_type == Protocol::GameEventType::LEVEL_COMPLETE) {
+        std::cout << "[Room " << _id << "] Broadcasting LEVEL_COMPLETE: "
+                  << event.levelName << " -> " << event.nextLevelName << std::endl;
+    }
+
+    RType::Network::EncodedPacket<sizeof(packet) + 16> encoded;
+    if (!RType::Network::encode(packet, encoded)) {
+        std::cerr << "[Room " << _id << "] Failed to encode GAME_EVENT" << std::endl;
+        return;
+    }
+    broadcastOrdered(encoded);
+}
+
+} // namespace RType::Server
@@ -0,0 +1,179 @@
+#include "RoomManager.hpp"
+#include "metrics/ServerMetrics.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace RType::Server {
+
+RoomManager::RoomManager(Network::INetworkModule& network, size_t workerCount, size_t maxRooms)
+    : _network(network)
+    , _workerCount(workerCount > 0 ? workerCount : 1)
+    , _maxRooms(maxRooms)
+    , _running(false)
+{
+}
+
+RoomManager::~RoomManager()
+{
+    stop();
+}
+
+void RoomManager::start()
+{
+    if (_running) {
+        return;
+    }
+
+    _running = true;
+    for (size_t i = 0; i < _workerCount; ++i) {
+        _workers.emplace_back(&RoomManager::workerLoop, this, i);
+    }
+
+    std::cout << "[RoomManager] Started " << _workerCount << " room workers" << std::endl;
+}
+
+void RoomManager::stop()
+{
+    if (!_running) {
+        return;
+    }
+
+    _running = false;
+    for (auto& worker : _workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    _workers.clear();
+}
+
+std::shared_ptr<Room> RoomManager::getOrCreateRoom(uint32_t room_id)
+{
+    std::lock_guard<std::mutex> lock(_roomsMutex);
+
+    auto it = _rooms.find(room_id);
+    if (it != _rooms.end()) {
+        return it->second;
+    }
+
+    if (_rooms.size() >= _maxRooms) {
+        return nullptr;
+    }
+
+    auto room = std::make_shared<Room>(room_id, _network);
+    _rooms[room_id] = room;
+
+    std::cout << "[RoomManager] Created room " << room_id
+              << " (" << _rooms.size() << " active)" << std::endl;
+    return room;
+}
+
+std::shared_ptr<Room> RoomManager::findRoom(uint32_t room_id) const
+{
+    std::lock_guard<std::mutex> lock(_roomsMutex);
+
+    auto it = _rooms.find(room_id);
+    if (it != _rooms.end()) {
+        return it->second;
+    }
+    return nullptr;
+}
+
+void RoomManager::reapIdleRooms(std::chrono::seconds grace)
+{
+    std::lock_guard<std::mutex> lock(_roomsMutex);
+
+    for (auto it = _rooms.begin(); it != _rooms.end();) {
+        if (it->second->isIdle(grace)) {
+            std::cout << "[RoomManager] Closing idle room " << it->first << std::endl;
+            it = _rooms.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+size_t RoomManager::getRoomCount() const
+{
+    std::lock_guard<std::mutex> lock(_roomsMutex);
+    return _rooms.size();
+}
+
+size_t RoomManager::getEntityCount() const
+{
+    std::lock_guard<std::mutex> lock(_roomsMutex);
+
+    size_t total = 0;
+    for (const auto& [id, room] : _rooms) {
+        total += room->getEntityCount();
+    }
+    return total;
+}
+
+void RoomManager::collectRooms(size_t index, std::vector<std::shared_ptr<Room>>& out) const
+{
+    out.clear();
+
+    std::lock_guard<std::mutex> lock(_roomsMutex);
+    for (const auto& [id, room] : _rooms) {
+        if (id % _workerCount == index) {
+            out.push_back(room);
+        }
+    }
+}
+
+void RoomManager::workerLoop(size_t index)
+{
+    using clock = std::chrono::steady_clock;
+    using namespace std::chrono;
+
+    constexpr auto TICK_RATE = milliseconds(16);
+    constexpr float FIXED_DT = 1.0f / 60.0f;
+    auto next_tick = clock::now();
+    std::vector<std::shared_ptr<Room>> rooms;
+    auto& metrics = Metrics::ServerMetrics::instance();
+    float timeScale = 1.0f;
+
+    while (_running) {
+        auto now = clock::now();
+
+        if (now < next_tick) {
+            std::this_thread::sleep_for(milliseconds(1));
+            continue;
+        }
+
+        // Run at most MAX_CATCHUP_TICKS per wake. Any debt beyond that is
+        // dropped: the simulation falls behind real time (time dilation)
+        // instead of spiralling into back-to-back ticks it cannot afford.
+        size_t due = 1 + static_cast<size_t>((now - next_tick) / TICK_RATE);
+        size_t run = std::min(due, MAX_CATCHUP_TICKS);
+
+        metrics.recordTicksBehind(due - 1);
+        if (run > 1) {
+            metrics.recordCatchUpTicks(run - 1);
+        }
+        if (due > run) {
+            metrics.recordTicksSkipped(due - run);
+        }
+
+        timeScale += TIME_SCALE_SMOOTHING * (static_cast<float>(run) / static_cast<float>(due) - timeScale);
+        auto percent = static_cast<uint8_t>(std::clamp(timeScale * 100.0f + 0.5f, 1.0f, 100.0f));
+        metrics.recordTimeScale(percent);
+
+        collectRooms(index, rooms);
+
+        for (size_t i = 0; i < run && !rooms.empty(); ++i) {
+            Metrics::ScopedTimer workerTimer(metrics.workerTick());
+            Network::SendBatch batch(_network);
+            for (auto& room : rooms) {
+                Metrics::ScopedTimer roomTimer(metrics.roomTick());
+                room->setTimeScale(percent);
+                room->tick(FIXED_DT);
+            }
+        }
+
+        next_tick += TICK_RATE * due;
+    }
+}
+
+} // namespace RType::Server
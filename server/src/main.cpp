@@ -1,6 +1,7 @@
 #include "Server.hpp"
 #include <iostream>
 #include <csignal>
+#include <cstring>
 
 std::unique_ptr<RType::Server::Server> g_server;
 
@@ -13,19 +14,72 @@ void signalHandler(int signal)
     exit(0);
 }
 
+void usage(const char* name)
+{
+    std::cout << "Usage: " << name << " [port] [options]\n"
+              << "  port                    UDP port (default 4242)\n"
+              << "  --workers <n>           room worker threads (default: one per core)\n"
+              << "  --metrics-file <path>   write Prometheus metrics there every 5 s\n"
+              << "  --metrics-socket <path> serve Prometheus metrics on this Unix socket\n"
+              << "  --shards <n>            SO_REUSEPORT receive sockets (default 1)\n"
+              << "  --mtu <bytes>           largest unfragmented datagram (default 1200)" << std::endl;
+}
+
 int main(int argc, char* argv[])
 {
     uint16_t port = 4242;
-    
-    if (argc > 1) {
-        port = std::atoi(argv[1]);
+    size_t workers = 0;
+    std::string metricsFile;
+    std::string metricsSocket;
+    size_t receiveShards = 1;
+    size_t mtu = 0;
+    bool havePort = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            usage(argv[0]);
+            return 0;
+        }
+        if (std::strncmp(arg, "--", 2) != 0) {
+            if (havePort) {
+                usage(argv[0]);
+                return 1;
+            }
+            port = static_cast<uint16_t>(std::atoi(arg));
+            havePort = true;
+            continue;
+        }
+
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!value) {
+            usage(argv[0]);
+            return 1;
+        }
+
+        if (std::strcmp(arg, "--workers") == 0) {
+            workers = std::atoi(value);
+        } else if (std::strcmp(arg, "--metrics-file") == 0) {
+            metricsFile = value;
+        } else if (std::strcmp(arg, "--metrics-socket") == 0) {
+            metricsSocket = value;
+        } else if (std::strcmp(arg, "--shards") == 0) {
+            receiveShards = std::atoi(value);
+        } else if (std::strcmp(arg, "--mtu") == 0) {
+            mtu = std::atoi(value);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+        ++i;
     }
     
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
     
     try {
-        g_server = std::make_unique<RType::Server::Server>(port);
+        g_server = std::make_unique<RType::Server::Server>(port, workers, metricsFile, metricsSocket, receiveShards, mtu);
         g_server->start();
         
         std::cout << "Server running on port " << port << std::endl;
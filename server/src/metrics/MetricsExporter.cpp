@@ -0,0 +1,214 @@
+#include "metrics/MetricsExporter.hpp"
+#include "metrics/Profiler.hpp"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace RType::Metrics {
+
+MetricsExporter::MetricsExporter(ServerMetrics& metrics,
+                                 std::string filePath,
+                                 std::string socketPath,
+                                 std::chrono::milliseconds interval)
+    : _metrics(metrics)
+    , _filePath(std::move(filePath))
+    , _socketPath(std::move(socketPath))
+    , _interval(interval)
+    , _listenFd(-1)
+    , _running(false)
+{
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    stop();
+}
+
+bool MetricsExporter::start()
+{
+    if (_running) {
+        return false;
+    }
+
+    if (!_socketPath.empty() && !openSocket()) {
+        return false;
+    }
+
+    _running = true;
+    _thread = std::thread(&MetricsExporter::exportLoop, this);
+
+    std::cout << "[Metrics] Exporting to "
+              << (_filePath.empty() ? "-" : _filePath) << " and "
+              << (_socketPath.empty() ? "-" : _socketPath) << std::endl;
+    return true;
+}
+
+void MetricsExporter::stop()
+{
+    if (!_running) {
+        return;
+    }
+
+    _running = false;
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+
+    if (_listenFd >= 0) {
+        ::close(_listenFd);
+        ::unlink(_socketPath.c_str());
+        _listenFd = -1;
+    }
+}
+
+bool MetricsExporter::openSocket()
+{
+    sockaddr_un addr{};
+    if (_socketPath.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "[Metrics] Socket path too long: " << _socketPath << std::endl;
+        return false;
+    }
+
+    _listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_listenFd < 0) {
+        std::cerr << "[Metrics] socket() failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, _socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    // A previous run that crashed leaves its socket file behind.
+    ::unlink(_socketPath.c_str());
+
+    if (::bind(_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(_listenFd, 8) < 0) {
+        std::cerr << "[Metrics] Cannot listen on " << _socketPath << ": " << std::strerror(errno) << std::endl;
+        ::close(_listenFd);
+        _listenFd = -1;
+        return false;
+    }
+
+    return true;
+}
+
+void MetricsExporter::exportLoop()
+{
+    using clock = std::chrono::steady_clock;
+
+    auto next_export = clock::now();
+
+    while (_running) {
+        auto now = clock::now();
+        if (now >= next_export) {
+            if (!_filePath.empty()) {
+                writeFile();
+            }
+            next_export = now + _interval;
+        }
+
+        // Wake at least every 100ms so stop() is never blocked for long.
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next_export - now).count();
+        int timeout = static_cast<int>(std::max<long long>(0, std::min<long long>(wait, 100)));
+
+        if (_listenFd < 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+            continue;
+        }
+
+        pollfd pfd{_listenFd, POLLIN, 0};
+        if (::poll(&pfd, 1, timeout) <= 0) {
+            continue;
+        }
+
+        int client = ::accept4(_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client >= 0) {
+            serveClient(client);
+            ::close(client);
+        }
+    }
+}
+
+void MetricsExporter::serveClient(int fd)
+{
+    std::string command;
+    char buffer[64];
+
+    // Clients that connect and say nothing (e.g. `nc -U sock </dev/null`)
+    // get the metrics once the short command timeout expires.
+    pollfd pfd{fd, POLLIN, 0};
+    while (command.size() < MAX_COMMAND_SIZE && command.find('\n') == std::string::npos) {
+        if (::poll(&pfd, 1, COMMAND_TIMEOUT_MS) <= 0) {
+            break;
+        }
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            break;
+        }
+        command.append(buffer, static_cast<size_t>(n));
+    }
+
+    auto end = command.find_first_of("\r\n");
+    if (end != std::string::npos) {
+        command.resize(end);
+    }
+
+    std::string response = handleCommand(command);
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t n = ::send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            break;
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
+
+std::string MetricsExporter::handleCommand(const std::string& command)
+{
+    if (command.empty() || command == "metrics") {
+        std::ostringstream out;
+        _metrics.writePrometheus(out, false);
+        return out.str();
+    }
+
+    if (command.rfind("profile", 0) == 0) {
+#ifdef RTYPE_PROFILER
+        size_t count = 60;
+        std::istringstream args(command.substr(7));
+        args >> count;
+        return Profiler::instance().dump(count);
+#else
+        return "profiler disabled, rebuild with -DRTYPE_ENABLE_PROFILER=ON\n";
+#endif
+    }
+
+    return "unknown command: " + command + "\n";
+}
+
+void MetricsExporter::writeFile()
+{
+    std::string tmpPath = _filePath + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::trunc);
+        if (!out) {
+            std::cerr << "[Metrics] Cannot write " << tmpPath << std::endl;
+            return;
+        }
+        _metrics.writePrometheus(out, true);
+    }
+
+    if (std::rename(tmpPath.c_str(), _filePath.c_str()) != 0) {
+        std::cerr << "[Metrics] Cannot rename " << tmpPath << ": " << std::strerror(errno) << std::endl;
+    }
+}
+
+} // namespace RType::Metrics
@@ -0,0 +1,113 @@
+#include "metrics/Profiler.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace RType::Metrics {
+
+Profiler& Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler()
+    : _ring(CAPACITY)
+    , _head(0)
+    , _size(0)
+    , _committed(0)
+    , _calibrationTicks(now())
+    , _calibrationTime(std::chrono::steady_clock::now())
+{
+}
+
+void Profiler::commit(const TickRecord& record)
+{
+    // The profiler is the only source of the per-phase histograms, so they
+    // stay empty in builds without it.
+    double scale = 1.0 / ticksPerMicro();
+    auto& metrics = ServerMetrics::instance();
+    for (size_t p = 0; p < PHASE_COUNT; ++p) {
+        if (record.phases[p] != 0) {
+            metrics.phase(static_cast<Phase>(p)).observe(static_cast<uint64_t>(record.phases[p] * scale));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _ring[_head] = record;
+    _head = (_head + 1) % CAPACITY;
+    _size = std::min(_size + 1, CAPACITY);
+    ++_committed;
+}
+
+double Profiler::ticksPerMicro() const
+{
+    // The TSC rate is derived from the time elapsed since start-up rather
+    // than a blocking calibration loop; it converges as the server runs.
+    auto elapsed = std::chrono::steady_clock::now() - _calibrationTime;
+    double micros = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / 1000.0;
+    double ticks = static_cast<double>(now() - _calibrationTicks);
+    if (micros <= 0.0 || ticks <= 0.0) {
+        return 1.0;
+    }
+    return ticks / micros;
+}
+
+std::string Profiler::dump(size_t n) const
+{
+    std::vector<TickRecord> records;
+    uint64_t committed;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        records.reserve(_size);
+        for (size_t i = 0; i < _size; ++i) {
+            records.push_back(_ring[(_head + CAPACITY - _size + i) % CAPACITY]);
+        }
+        committed = _committed;
+    }
+
+    double scale = 1.0 / ticksPerMicro();
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+
+    n = std::min(n, records.size());
+    out << "# last " << n << " of " << committed << " ticks (us)\n";
+    out << "# tick room total";
+    for (size_t p = 0; p < PHASE_COUNT; ++p) {
+        out << " " << phaseName(static_cast<Phase>(p));
+    }
+    out << "\n";
+
+    for (size_t i = records.size() - n; i < records.size(); ++i) {
+        const auto& record = records[i];
+        out << committed - records.size() + i << " " << record.room_id << " " << record.total * scale;
+        for (size_t p = 0; p < PHASE_COUNT; ++p) {
+            out << " " << record.phases[p] * scale;
+        }
+        out << "\n";
+    }
+
+    out << "# phase summary over " << records.size() << " ticks: p50 p99 max (us)\n";
+    std::vector<uint64_t> samples(records.size());
+    auto summarize = [&](const char* name, auto select) {
+        if (samples.empty()) {
+            return;
+        }
+        std::transform(records.begin(), records.end(), samples.begin(), select);
+        std::sort(samples.begin(), samples.end());
+        auto at = [&](double q) {
+            return samples[static_cast<size_t>(q * static_cast<double>(samples.size() - 1))] * scale;
+        };
+        out << name << " " << at(0.50) << " " << at(0.99) << " " << samples.back() * scale << "\n";
+    };
+
+    summarize("total", [](const TickRecord& r) { return r.total; });
+    for (size_t p = 0; p < PHASE_COUNT; ++p) {
+        summarize(phaseName(static_cast<Phase>(p)), [p](const TickRecord& r) { return r.phases[p]; });
+    }
+
+    return out.str();
+}
+
+} // namespace RType::Metrics
@@ -0,0 +1,179 @@
+#include "metrics/ServerMetrics.hpp"
+#include "protocol/Protocol.hpp"
+
+namespace RType::Metrics {
+
+const char* phaseName(Phase phase)
+{
+    switch (phase) {
+        case Phase::INBOX: return "inbox";
+        case Phase::LEVEL_UPDATE: return "level_update";
+        case Phase::MOVEMENT: return "movement";
+        case Phase::CLAMP: return "clamp";
+        case Phase::COOLDOWNS: return "cooldowns";
+        case Phase::BOSS_CHECK: return "boss_check";
+        case Phase::CHARGE_STATES: return "charge_states";
+        case Phase::ENEMIES: return "enemies";
+        case Phase::COLLISIONS: return "collisions";
+        case Phase::PROJECTILE_CLEANUP: return "projectile_cleanup";
+        case Phase::REGISTRY_CLEANUP: return "registry_cleanup";
+        case Phase::SNAPSHOT: return "snapshot";
+        default: return "unknown";
+    }
+}
+
+const char* packetTypeName(uint8_t type)
+{
+    using Protocol::PacketType;
+
+    switch (static_cast<PacketType>(type)) {
+        case PacketType::CONNECT_REQUEST: return "CONNECT_REQUEST";
+        case PacketType::CONNECT_RESPONSE: return "CONNECT_RESPONSE";
+        case PacketType::DISCONNECT: return "DISCONNECT";
+        case PacketType::PLAYER_JOINED: return "PLAYER_JOINED";
+        case PacketType::READY_TO_PLAY: return "READY_TO_PLAY";
+        case PacketType::LOBBY_STATUS: return "LOBBY_STATUS";
+        case PacketType::PLAYER_INPUT: return "PLAYER_INPUT";
+        case PacketType::PLAYER_MOVE: return "PLAYER_MOVE";
+        case PacketType::PLAYER_SHOOT: return "PLAYER_SHOOT";
+        case PacketType::WORLD_STATE: return "WORLD_STATE";
+        case PacketType::ENTITY_SPAWN: return "ENTITY_SPAWN";
+        case PacketType::ENTITY_DESTROY: return "ENTITY_DESTROY";
+        case PacketType::ENTITY_UPDATE: return "ENTITY_UPDATE";
+        case PacketType::SCORE_UPDATE: return "SCORE_UPDATE";
+        case PacketType::ENTITY_FIRE: return "ENTITY_FIRE";
+        case PacketType::PLAYER_DEATH: return "PLAYER_DEATH";
+        case PacketType::GAME_EVENT: return "GAME_EVENT";
+        case PacketType::SNAPSHOT_ACK: return "SNAPSHOT_ACK";
+        case PacketType::GAME_ON: return "GAME_ON";
+        case PacketType::GAME_OFF: return "GAME_OFF";
+        case PacketType::GAME_OVER: return "GAME_OVER";
+        case PacketType::ACK: return "ACK";
+        case PacketType::FRAGMENT: return "FRAGMENT";
+        case PacketType::BUNDLE: return "BUNDLE";
+        case PacketType::ORDERED: return "ORDERED";
+        case PacketType::PING: return "PING";
+        case PacketType::PONG: return "PONG";
+        default: return "UNKNOWN";
+    }
+}
+
+ServerMetrics& ServerMetrics::instance()
+{
+    static ServerMetrics metrics;
+    return metrics;
+}
+
+namespace {
+    void writeHelp(std::ostream& out, const char* name, const char* type, const char* help)
+    {
+        out << "# HELP " << name << " " << help << "\n";
+        out << "# TYPE " << name << " " << type << "\n";
+    }
+
+    void writePerType(std::ostream& out, const char* name, const char* help,
+                      const std::array<std::atomic<uint64_t>, 256>& values)
+    {
+        writeHelp(out, name, "counter", help);
+        for (size_t i = 0; i < values.size(); ++i) {
+            uint64_t value = values[i].load(std::memory_order_relaxed);
+            if (value != 0) {
+                out << name << "{type=\"" << packetTypeName(static_cast<uint8_t>(i)) << "\"} " << value << "\n";
+            }
+        }
+    }
+
+    uint64_t peak(std::atomic<uint64_t>& value, bool reset)
+    {
+        return reset ? value.exchange(0, std::memory_order_relaxed) : value.load(std::memory_order_relaxed);
+    }
+}
+
+void ServerMetrics::writePrometheus(std::ostream& out, bool resetPeaks)
+{
+    writeHelp(out, "rtype_worker_tick_seconds", "histogram", "Time for a room worker to tick all of its rooms");
+    _workerTick.writePrometheus(out, "rtype_worker_tick_seconds");
+
+    writeHelp(out, "rtype_room_tick_seconds", "histogram", "Time to tick a single room");
+    _roomTick.writePrometheus(out, "rtype_room_tick_seconds");
+
+    writeHelp(out, "rtype_tick_phase_seconds", "histogram", "Time spent in each phase of a room tick");
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        std::string labels = std::string("phase=\"") + phaseName(static_cast<Phase>(i)) + "\"";
+        _phases[i].writePrometheus(out, "rtype_tick_phase_seconds", labels);
+    }
+
+    writeHelp(out, "rtype_tick_p99_seconds", "gauge", "Estimated 99th percentile room tick time since start");
+    out << "rtype_tick_p99_seconds " << _roomTick.percentile(0.99) / 1e6 << "\n";
+
+    writeHelp(out, "rtype_ticks_behind_max", "gauge", "Largest tick debt a worker woke up with since last export");
+    out << "rtype_ticks_behind_max " << peak(_ticksBehindMax, resetPeaks) << "\n";
+    writeHelp(out, "rtype_catchup_ticks_total", "counter", "Extra ticks run back to back to catch up");
+    out << "rtype_catchup_ticks_total " << _catchUpTicks.load(std::memory_order_relaxed) << "\n";
+    writeHelp(out, "rtype_ticks_skipped_total", "counter", "Ticks dropped because the catch-up budget was exhausted");
+    out << "rtype_ticks_skipped_total " << _ticksSkipped.load(std::memory_order_relaxed) << "\n";
+    writeHelp(out, "rtype_time_scale_min", "gauge", "Lowest simulation time scale (percent of real time) since last export");
+    out << "rtype_time_scale_min "
+        << (resetPeaks ? _timeScaleMin.exchange(100, std::memory_order_relaxed)
+                       : _timeScaleMin.load(std::memory_order_relaxed)) << "\n";
+
+    writePerType(out, "rtype_packets_in_total", "Packets received by type", _packetsIn);
+    writePerType(out, "rtype_bytes_in_total", "Bytes received by packet type", _bytesIn);
+    writePerType(out, "rtype_packets_out_total", "Packets sent by type", _packetsOut);
+    writePerType(out, "rtype_bytes_out_total", "Bytes sent by packet type", _bytesOut);
+
+    writeHelp(out, "rtype_socket_send_calls_total", "counter", "Socket send calls (each may carry a batch of datagrams)");
+    out << "rtype_socket_send_calls_total " << _sendCalls.load(std::memory_order_relaxed) << "\n";
+    writeHelp(out, "rtype_socket_recv_calls_total", "counter", "Socket receive calls that returned at least one datagram");
+    out << "rtype_socket_recv_calls_total " << _recvCalls.load(std::memory_order_relaxed) << "\n";
+
+    writeHelp(out, "rtype_packet_pool_exhausted_total", "counter", "Datagrams dropped because every receive buffer was in use");
+    out << "rtype_packet_pool_exhausted_total " << _poolExhausted.load(std::memory_order_relaxed) << "\n";
+
+    writeHelp(out, "rtype_message_queue_depth", "gauge", "Network receive queue depth at last poll");
+    out << "rtype_message_queue_depth " << _queueDepth.load(std::memory_order_relaxed) << "\n";
+    writeHelp(out, "rtype_message_queue_depth_max", "gauge", "Peak receive queue depth since last export");
+    out << "rtype_message_queue_depth_max " << peak(_queueDepthMax, resetPeaks) << "\n";
+    writeHelp(out, "rtype_room_inbox_depth_max", "gauge", "Peak room inbox depth since last export");
+    out << "rtype_room_inbox_depth_max " << peak(_inboxDepthMax, resetPeaks) << "\n";
+    writeHelp(out, "rtype_room_inbox_dropped_total", "counter", "Messages dropped because a room inbox was full");
+    out << "rtype_room_inbox_dropped_total " << _inboxDropped.load(std::memory_order_relaxed) << "\n";
+
+    writeHelp(out, "rtype_reliable_retransmits_total", "counter", "Reliable packets sent again after a timeout");
+    out << "rtype_reliable_retransmits_total " << _retransmits.load(std::memory_order_relaxed) << "\n";
+    writeHelp(out, "rtype_retransmit_lateness_seconds", "histogram", "How long after its deadline a retransmit was sent");
+    _retransmitLateness.writePrometheus(out, "rtype_retransmit_lateness_seconds", "");
+    writeHelp(out, "rtype_peer_rtt_seconds", "histogram", "Round-trip samples from acks and pings, all peers");
+    _peerRtt.writePrometheus(out, "rtype_peer_rtt_seconds", "");
+    writeHelp(out, "rtype_retransmit_timeout_seconds", "histogram", "Per-peer retransmit timeout after each RTT sample");
+    _retransmitTimeout.writePrometheus(out, "rtype_retransmit_timeout_seconds", "");
+    writeHelp(out, "rtype_reliable_dropped_total", "counter", "Reliable packets abandoned after max retries");
+    out << "rtype_reliable_dropped_total " << _reliableDropped.load(std::memory_order_relaxed) << "\n";
+    writeHelp(out, "rtype_messages_fragmented_total", "counter", "Outgoing messages larger than the MTU, sent as fragments");
+    out << "rtype_messages_fragmented_total " << _messagesFragmented.load(std::memory_order_relaxed) << "\n";
+    writeHelp(out, "rtype_fragments_sent_total", "counter", "Fragments sent for those messages");
+    out << "rtype_fragments_sent_total " << _fragmentsSent.load(std::memory_order_relaxed) << "\n";
+    writeHelp(out, "rtype_bundles_sent_total", "counter", "Datagrams carrying several messages for one client");
+    out << "rtype_bundles_sent_total " << _bundlesSent.load(std::memory_order_relaxed) << "\n";
+    writeHelp(out, "rtype_messages_bundled_total", "counter", "Messages sent inside those bundles");
+    out << "rtype_messages_bundled_total " << _messagesBundled.load(std::memory_order_relaxed) << "\n";
+    writeHelp(out, "rtype_reassembly_dropped_total", "counter", "Incoming fragmented messages abandoned (timed out, evicted or malformed)");
+    out << "rtype_reassembly_dropped_total " << _reassemblyDropped.load(std::memory_order_relaxed) << "\n";
+    writeHelp(out, "rtype_snapshot_entities_deferred_total", "counter", "Changed entities left out of a snapshot by the per-client byte budget");
+    out << "rtype_snapshot_entities_deferred_total " << _snapshotDeferred.load(std::memory_order_relaxed) << "\n";
+    writeHelp(out, "rtype_snapshot_compression_total", "counter", "Snapshots offered to the codec, by whether compression paid");
+    out << "rtype_snapshot_compression_total{result=\"compressed\"} " << _snapshotsCompressed.load(std::memory_order_relaxed) << "\n";
+    out << "rtype_snapshot_compression_total{result=\"skipped\"} " << _snapshotsUncompressed.load(std::memory_order_relaxed) << "\n";
+    writeHelp(out, "rtype_snapshot_body_bytes_total", "counter", "Bodies of those snapshots before and after compression");
+    out << "rtype_snapshot_body_bytes_total{stage=\"uncompressed\"} " << _snapshotBytesUncompressed.load(std::memory_order_relaxed) << "\n";
+    out << "rtype_snapshot_body_bytes_total{stage=\"sent\"} " << _snapshotBytesSent.load(std::memory_order_relaxed) << "\n";
+
+    writeHelp(out, "rtype_rooms", "gauge", "Active rooms");
+    out << "rtype_rooms " << _rooms.load(std::memory_order_relaxed) << "\n";
+    writeHelp(out, "rtype_clients", "gauge", "Connected clients");
+    out << "rtype_clients " << _clients.load(std::memory_order_relaxed) << "\n";
+    writeHelp(out, "rtype_entities", "gauge", "Entities across all rooms at last snapshot");
+    out << "rtype_entities " << _entities.load(std::memory_order_relaxed) << "\n";
+}
+
+} // namespace RType::Metrics
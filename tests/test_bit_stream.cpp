@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "network/BitStream.hpp"
+#include "protocol/Protocol.hpp"
+#include <cstring>
+
+using RType::Network::BitReader;
+using RType::Network::BitWriter;
+
+namespace {
+
+// Exercises every primitive through one serialize(), like a message would.
+struct Sample {
+    bool flag = false;
+    int level = 0;
+    uint32_t count = 0;
+    float x = 0.f;
+    char name[16] = {};
+
+    template<typename Stream>
+    bool serialize(Stream& stream)
+    {
+        return stream.serializeBool(flag) && stream.serializeInt(level, -5, 10)
+            && stream.serializeVarint(count) && stream.serializeFloat(x, 0.f, 1920.f, 0.1f)
+            && stream.serializeString(name, sizeof(name));
+    }
+};
+
+}
+
+TEST(BitStreamTest, BitsRequired) {
+    EXPECT_EQ(RType::Network::bitsRequired(0), 0u);
+    EXPECT_EQ(RType::Network::bitsRequired(1), 1u);
+    EXPECT_EQ(RType::Network::bitsRequired(4), 3u);
+    EXPECT_EQ(RType::Network::bitsRequired(255), 8u);
+    EXPECT_EQ(RType::Network::bitsRequired(256), 9u);
+}
+
+TEST(BitStreamTest, RoundTripsEveryPrimitive) {
+    Sample in;
+    in.flag = true;
+    in.level = -3;
+    in.count = 300000;
+    in.x = 812.34f;
+    std::strcpy(in.name, "Level 2");
+
+    uint8_t buffer[64];
+    BitWriter writer(buffer, sizeof(buffer));
+    ASSERT_TRUE(in.serialize(writer));
+    ASSERT_TRUE(writer.flush());
+
+    Sample out;
+    BitReader reader(buffer, writer.bytesWritten());
+    ASSERT_TRUE(out.serialize(reader));
+    EXPECT_TRUE(out.flag);
+    EXPECT_EQ(out.level, -3);
+    EXPECT_EQ(out.count, 300000u);
+    EXPECT_NEAR(out.x, 812.34f, 0.05f);
+    EXPECT_STREQ(out.name, "Level 2");
+    EXPECT_EQ(reader.bytesRead(), writer.bytesWritten());
+}
+
+TEST(BitStreamTest, TruncatedInputFails) {
+    Sample in;
+    std::strcpy(in.name, "truncated");
+
+    uint8_t buffer[64];
+    BitWriter writer(buffer, sizeof(buffer));
+    ASSERT_TRUE(in.serialize(writer));
+    ASSERT_TRUE(writer.flush());
+
+    Sample out;
+    BitReader reader(buffer, writer.bytesWritten() - 1);
+    EXPECT_FALSE(out.serialize(reader));
+    EXPECT_TRUE(reader.failed());
+    uint32_t bit = 0;
+    EXPECT_FALSE(reader.serializeBits(bit, 1));
+}
+
+TEST(BitStreamTest, RejectsOutOfRangeValues) {
+    uint8_t buffer[8];
+    BitWriter writer(buffer, sizeof(buffer));
+    int value = 11;
+    EXPECT_FALSE(writer.serializeInt(value, 0, 10));
+    EXPECT_TRUE(writer.failed());
+
+    // 4 bits can carry 15 even though the range stops at 10.
+    buffer[0] = 0x0F;
+    BitReader reader(buffer, 1);
+    EXPECT_FALSE(reader.serializeInt(value, 0, 10));
+}
+
+TEST(BitStreamTest, WriterFailsWhenFull) {
+    uint8_t buffer[2];
+    BitWriter writer(buffer, sizeof(buffer));
+    uint32_t value = 0xABCDEF;
+    EXPECT_FALSE(writer.serializeBits(value, 24));
+    EXPECT_TRUE(writer.failed());
+}
+
+TEST(BitStreamTest, GameEventEncodesSmallerThanItsStruct) {
+    RType::Protocol::GameEvent event;
+    event.event_type = RType::Protocol::GameEventType::LEVEL_COMPLETE;
+    event.entityId = 42;
+    event.scoreGain = 150;
+    std::strcpy(event.levelName, "Level 1");
+    std::strcpy(event.nextLevelName, "Level 2");
+
+    RType::Network::EncodedPacket<sizeof(event) + 16> encoded;
+    ASSERT_TRUE(RType::Network::encode(event, encoded));
+    EXPECT_LT(encoded.getPacketSize(), sizeof(event) / 4);
+
+    RType::Protocol::GameEvent decoded;
+    ASSERT_TRUE(RType::Network::decode(encoded.bytes, encoded.size, decoded));
+    EXPECT_EQ(decoded.header.type, RType::Protocol::PacketType::GAME_EVENT);
+    EXPECT_EQ(decoded.event_type, RType::Protocol::GameEventType::LEVEL_COMPLETE);
+    EXPECT_EQ(decoded.entityId, 42u);
+    EXPECT_EQ(decoded.scoreGain, 150u);
+    EXPECT_STREQ(decoded.levelName, "Level 1");
+    EXPECT_STREQ(decoded.nextLevelName, "Level 2");
+}
+
+TEST(BitStreamTest, GameOverRoundTrip) {
+    RType::Protocol::GameOver over;
+    over.num_players = 2;
+    over.players[0].client_id = 1;
+    over.players[0].score = 12000;
+    std::strcpy(over.players[0].player_name, "alice");
+    over.players[1].client_id = 2;
+    over.players[1].enemies_killed = 17;
+
+    RType::Network::EncodedPacket<sizeof(over) + 16> encoded;
+    ASSERT_TRUE(RType::Network::encode(over, encoded));
+
+    RType::Protocol::GameOver decoded;
+    ASSERT_TRUE(RType::Network::decode(encoded.bytes, encoded.size, decoded));
+    EXPECT_EQ(decoded.num_players, 2);
+    EXPECT_EQ(decoded.players[0].score, 12000u);
+    EXPECT_STREQ(decoded.players[0].player_name, "alice");
+    EXPECT_EQ(decoded.players[1].enemies_killed, 17u);
+
+    EXPECT_FALSE(RType::Network::decode(encoded.bytes, encoded.size - 2, decoded));
+}
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include "network/DeltaHistory.hpp"
+
+using History = RType::Network::DeltaHistory<int, 4>;
+
+TEST(DeltaHistoryTest, FindsStateByTick) {
+    History history;
+    history.record(7, 1, 10);
+    history.record(7, 2, 20);
+    history.record(8, 2, 80);
+
+    ASSERT_NE(history.find(7, 1), nullptr);
+    EXPECT_EQ(*history.find(7, 1), 10);
+    EXPECT_EQ(*history.find(7, 2), 20);
+    EXPECT_EQ(*history.find(8, 2), 80);
+    EXPECT_EQ(history.find(8, 1), nullptr);
+    EXPECT_EQ(history.find(9, 2), nullptr);
+}
+
+TEST(DeltaHistoryTest, KeepsOnlyTheLastDepthStates) {
+    History history;
+    for (uint32_t tick = 1; tick <= 5; ++tick) {
+        history.record(7, tick, static_cast<int>(tick) * 10);
+    }
+    EXPECT_EQ(history.find(7, 1), nullptr);
+    EXPECT_EQ(*history.find(7, 2), 20);
+    EXPECT_EQ(*history.find(7, 5), 50);
+}
+
+TEST(DeltaHistoryTest, EraseForgetsEntity) {
+    History history;
+    history.record(7, 1, 10);
+    history.record(8, 1, 80);
+    history.erase(7);
+
+    EXPECT_EQ(history.find(7, 1), nullptr);
+    EXPECT_EQ(history.size(), 1u);
+    history.clear();
+    EXPECT_EQ(history.size(), 0u);
+}
@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+#include "network/Endpoint.hpp"
+
+using namespace RType::Network;
+
+TEST(EndpointTest, IPv4RoundTripsThroughNative) {
+    Endpoint endpoint("192.168.1.20", 4242);
+    EXPECT_TRUE(endpoint.isV4());
+    EXPECT_EQ(endpoint.port(), 4242);
+    EXPECT_EQ(endpoint.toString(), "192.168.1.20:4242");
+
+    sockaddr_storage native;
+    ASSERT_EQ(endpoint.toNative(native, AF_INET), sizeof(sockaddr_in));
+    EXPECT_EQ(Endpoint::fromNative(native), endpoint);
+}
+
+TEST(EndpointTest, IPv6IsNotReachableFromIPv4Socket) {
+    Endpoint endpoint("2001:db8::1", 80);
+    EXPECT_FALSE(endpoint.isV4());
+    EXPECT_EQ(endpoint.toString(), "[2001:db8::1]:80");
+
+    sockaddr_storage native;
+    EXPECT_EQ(endpoint.toNative(native, AF_INET), 0u);
+    ASSERT_EQ(endpoint.toNative(native, AF_INET6), sizeof(sockaddr_in6));
+    EXPECT_EQ(Endpoint::fromNative(native), endpoint);
+}
+
+TEST(EndpointTest, EqualityAndHashCoverPort) {
+    Endpoint a("127.0.0.1", 5000);
+    Endpoint b("127.0.0.1", 5000);
+    Endpoint c("127.0.0.1", 5001);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a.hash(), b.hash());
+    EXPECT_NE(a, c);
+    EXPECT_NE(a.hash(), c.hash());
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "network/HuffmanCodec.hpp"
+#include "network/SnapshotCodec.hpp"
+#include <array>
+#include <vector>
+
+using RType::Network::HuffmanCodec;
+
+namespace {
+
+HuffmanCodec skewedCodec()
+{
+    std::array<uint32_t, HuffmanCodec::SYMBOLS> frequencies{};
+    frequencies[0] = 1000;
+    frequencies['a'] = 500;
+    frequencies['b'] = 100;
+    return HuffmanCodec(frequencies);
+}
+
+}
+
+TEST(HuffmanCodecTest, CommonBytesGetShorterCodes) {
+    HuffmanCodec codec = skewedCodec();
+    EXPECT_LT(codec.codeLength(0), codec.codeLength('b'));
+    EXPECT_LT(codec.codeLength('b'), codec.codeLength('z'));
+    for (size_t s = 0; s < HuffmanCodec::SYMBOLS; ++s) {
+        EXPECT_LE(codec.codeLength(static_cast<uint8_t>(s)), HuffmanCodec::MAX_CODE_LENGTH);
+    }
+}
+
+TEST(HuffmanCodecTest, RoundTripsEveryByte) {
+    HuffmanCodec codec = skewedCodec();
+    std::vector<uint8_t> input(600, 0);
+    for (size_t i = 0; i < 256; ++i) {
+        input[i * 2] = static_cast<uint8_t>(i);
+    }
+
+    std::vector<uint8_t> packed(input.size());
+    size_t size = codec.compress(input.data(), input.size(), packed.data(), packed.size());
+    ASSERT_GT(size, 0u);
+    EXPECT_LT(size, input.size());
+
+    std::vector<uint8_t> output(input.size());
+    ASSERT_EQ(codec.decompress(packed.data(), size, output.data(), output.size()), input.size());
+    EXPECT_EQ(output, input);
+}
+
+TEST(HuffmanCodecTest, SkipsInputThatDoesNotShrink) {
+    HuffmanCodec codec = skewedCodec();
+    std::vector<uint8_t> rare(64, 'z');
+    std::vector<uint8_t> packed(256);
+    EXPECT_EQ(codec.compress(rare.data(), rare.size(), packed.data(), packed.size()), 0u);
+}
+
+TEST(HuffmanCodecTest, RejectsTruncatedAndOversizedInput) {
+    HuffmanCodec codec = skewedCodec();
+    std::vector<uint8_t> input(100, 'a');
+    std::vector<uint8_t> packed(input.size());
+    size_t size = codec.compress(input.data(), input.size(), packed.data(), packed.size());
+    ASSERT_GT(size, 1u);
+
+    std::vector<uint8_t> output(input.size());
+    EXPECT_EQ(codec.decompress(packed.data(), size - 1, output.data(), output.size()), 0u);
+    EXPECT_EQ(codec.decompress(packed.data(), size, output.data(), input.size() - 1), 0u);
+}
+
+TEST(HuffmanCodecTest, SnapshotCodecFitsMaximumCodeLength) {
+    // Skewed training data must not push any byte past MAX_CODE_LENGTH.
+    const HuffmanCodec& codec = RType::Network::snapshotCodec();
+    for (size_t s = 0; s < HuffmanCodec::SYMBOLS; ++s) {
+        EXPECT_GT(codec.codeLength(static_cast<uint8_t>(s)), 0u);
+        EXPECT_LE(codec.codeLength(static_cast<uint8_t>(s)), HuffmanCodec::MAX_CODE_LENGTH);
+    }
+}
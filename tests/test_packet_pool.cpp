@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include "network/PacketPool.hpp"
+
+using namespace RType::Network;
+
+TEST(PacketPoolTest, ReturnsSlabWhenLastHandleDies) {
+    PacketPool pool(2, 64);
+    {
+        PacketBuffer a = pool.acquire();
+        PacketBuffer copy = a;
+        EXPECT_EQ(pool.available(), 1u);
+        a = PacketBuffer();
+        EXPECT_EQ(pool.available(), 1u);
+    }
+    EXPECT_EQ(pool.available(), 2u);
+}
+
+TEST(PacketPoolTest, EmptyHandleWhenExhausted) {
+    PacketPool pool(1, 64);
+    PacketBuffer held = pool.acquire();
+    ASSERT_TRUE(held);
+    EXPECT_FALSE(pool.acquire());
+}
+
+TEST(PacketPoolTest, ResizeIsClampedToCapacity) {
+    PacketPool pool(1, 64);
+    PacketBuffer buffer = pool.acquire();
+    buffer.resize(10);
+    EXPECT_EQ(buffer.size(), 10u);
+    buffer.resize(1000);
+    EXPECT_EQ(buffer.size(), 64u);
+}
+
+TEST(PacketPoolTest, AssignCopiesOutsidePool) {
+    const uint8_t bytes[] = {1, 2, 3};
+    PacketBuffer buffer;
+    buffer.assign(bytes, bytes + sizeof(bytes));
+    ASSERT_EQ(buffer.size(), 3u);
+    EXPECT_EQ(buffer.data()[2], 3);
+}
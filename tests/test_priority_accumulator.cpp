@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include "core/PriorityAccumulator.hpp"
+
+using RType::Core::PriorityAccumulator;
+
+TEST(PriorityAccumulatorTest, RanksByAccumulatedPriority) {
+    PriorityAccumulator priorities;
+    priorities.beginRound();
+    priorities.add(1, 1.f, 0);
+    priorities.add(2, 10.f, 1);
+    priorities.add(3, 4.f, 2);
+
+    const auto& ranked = priorities.ranked();
+    ASSERT_EQ(ranked.size(), 3u);
+    EXPECT_EQ(ranked[0].id, 2u);
+    EXPECT_EQ(ranked[1].id, 3u);
+    EXPECT_EQ(ranked[2].id, 1u);
+    EXPECT_EQ(ranked[2].index, 0u);
+}
+
+TEST(PriorityAccumulatorTest, UnsentItemsAreEventuallySent) {
+    // Budget of one item per round: the low-weight item must win a round
+    // before the high-weight one has built up as much again.
+    PriorityAccumulator priorities;
+    int rounds = 0;
+    bool lowSent = false;
+    while (!lowSent && rounds < 100) {
+        priorities.beginRound();
+        priorities.add(1, 10.f, 0);
+        priorities.add(2, 1.f, 1);
+        uint32_t winner = priorities.ranked().front().id;
+        priorities.sent(winner);
+        lowSent = winner == 2;
+        ++rounds;
+    }
+
+    EXPECT_TRUE(lowSent);
+    EXPECT_LE(rounds, 12);
+}
+
+TEST(PriorityAccumulatorTest, SentResetsAndRetainForgets) {
+    PriorityAccumulator priorities;
+    priorities.beginRound();
+    priorities.add(1, 3.f, 0);
+    priorities.add(2, 3.f, 1);
+    priorities.sent(1);
+    EXPECT_EQ(priorities.priority(1), 0.f);
+    EXPECT_EQ(priorities.priority(2), 3.f);
+
+    priorities.retain([](uint32_t id) { return id != 2; });
+    EXPECT_EQ(priorities.priority(2), 0.f);
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "protocol/Protocol.hpp"
+#include "INetworkModule.hpp"
+#include "network/BitStream.hpp"
 #include <cstring>
 
 using namespace RType::Protocol;
@@ -89,13 +91,24 @@ TEST(ProtocolTest, LobbyStatusInitialization) {
 
 TEST(ProtocolTest, ScoreUpdate) {
     ScoreUpdate score;
-    score.client_id = 1;
-    score.score = 1000;
-    score.enemies_killed = 10;
-    
-    EXPECT_EQ(score.client_id, 1);
-    EXPECT_EQ(score.score, 1000);
-    EXPECT_EQ(score.enemies_killed, 10);
+    score.num_players = 2;
+    score.players[0] = {1, 1000, 10};
+    score.players[1] = {2, 250, 3};
+    score.players[2] = {3, 999, 9};        // past num_players, not sent
+
+    RType::Network::EncodedPacket<sizeof(ScoreUpdate) + 16> encoded;
+    ASSERT_TRUE(RType::Network::encode(score, encoded));
+
+    ScoreUpdate decoded;
+    ASSERT_TRUE(RType::Network::decode(encoded.bytes, encoded.size, decoded));
+    ASSERT_EQ(decoded.num_players, 2);
+    EXPECT_EQ(decoded.players[0].client_id, 1u);
+    EXPECT_EQ(decoded.players[0].score, 1000u);
+    EXPECT_EQ(decoded.players[0].enemies_killed, 10u);
+    EXPECT_EQ(decoded.players[1].client_id, 2u);
+    EXPECT_EQ(decoded.players[1].score, 250u);
+    EXPECT_EQ(decoded.players[1].enemies_killed, 3u);
+    EXPECT_EQ(decoded.players[2].client_id, 0u);
 }
 
 TEST(ProtocolTest, PacketSerialization) {
@@ -112,4 +125,45 @@ TEST(ProtocolTest, PacketSerialization) {
     EXPECT_EQ(deserialized.header.magic, request.header.magic);
     EXPECT_EQ(deserialized.header.sequence_number, 42);
     EXPECT_STREQ(deserialized.client_version, "1.0.0");
-}
\ No newline at end of file
+}
+
+TEST(ProtocolTest, BatchedEntityUpdateCarriesOnlyChangedFields) {
+    BatchedEntityUpdate batch;
+    batch.tick = 77;
+    batch.entity_count = 2;
+    batch.entities[0].entity_id = 5;
+    batch.entities[0].change_mask = CHANGED_POSITION;
+    batch.entities[0].baseline_age = 3;
+    batch.entities[0].pos_x = -120;
+    batch.entities[0].pos_y = 4000;
+    batch.entities[0].hp_current = 99;      // not flagged, not sent
+    batch.entities[1].entity_id = 6;
+    batch.entities[1].change_mask = ENTITY_REMOVED;
+
+    RType::Network::EncodedPacket<sizeof(BatchedEntityUpdate)> encoded;
+    ASSERT_TRUE(RType::Network::encode(batch, encoded));
+    EXPECT_LT(encoded.getPacketSize(), sizeof(PacketHeader) + 2 * sizeof(QuantizedEntityData));
+
+    BatchedEntityUpdate decoded;
+    ASSERT_TRUE(RType::Network::decode(encoded.bytes, encoded.size, decoded));
+    EXPECT_EQ(decoded.tick, 77u);
+    ASSERT_EQ(decoded.entity_count, 2);
+    EXPECT_EQ(decoded.entities[0].entity_id, 5u);
+    EXPECT_EQ(decoded.entities[0].baseline_age, 3u);
+    EXPECT_EQ(decoded.entities[0].pos_x, -120);
+    EXPECT_EQ(decoded.entities[0].pos_y, 4000);
+    EXPECT_EQ(decoded.entities[0].hp_current, 0);
+    EXPECT_EQ(decoded.entities[1].entity_id, 6u);
+    EXPECT_EQ(decoded.entities[1].change_mask, ENTITY_REMOVED);
+
+    QuantizedEntityData state;
+    state.hp_current = 50;
+    applyEntityDelta(state, decoded.entities[0]);
+    EXPECT_EQ(state.pos_x, -120);
+    EXPECT_EQ(state.hp_current, 50);
+}
+
+TEST(ProtocolTest, WireSizeOfFixedMessages) {
+    PlayerDeath death;
+    EXPECT_EQ(RType::Network::wireSize(death), sizeof(PlayerDeath));
+}
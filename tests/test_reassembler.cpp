@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "network/Reassembler.hpp"
+#include <numeric>
+#include <vector>
+
+using RType::Network::Endpoint;
+using RType::Network::Reassembler;
+
+namespace {
+
+// Splits message the way NetworkModule does, in chunk-sized pieces.
+std::vector<Reassembler::Fragment> split(const std::vector<uint8_t>& message, uint16_t id, size_t chunk)
+{
+    std::vector<Reassembler::Fragment> fragments;
+    size_t count = (message.size() + chunk - 1) / chunk;
+    for (size_t i = 0; i < count; ++i) {
+        size_t offset = i * chunk;
+        fragments.push_back(Reassembler::Fragment{id, static_cast<uint8_t>(i), static_cast<uint8_t>(count),
+                                                  static_cast<uint32_t>(message.size()),
+                                                  static_cast<uint32_t>(offset), message.data() + offset,
+                                                  std::min(chunk, message.size() - offset)});
+    }
+    return fragments;
+}
+
+std::vector<uint8_t> makeMessage(size_t size)
+{
+    std::vector<uint8_t> message(size);
+    std::iota(message.begin(), message.end(), uint8_t{0});
+    return message;
+}
+
+}
+
+TEST(ReassemblerTest, RebuildsOutOfOrderFragments) {
+    Reassembler reassembler;
+    Endpoint peer("127.0.0.1", 4242);
+    auto now = Reassembler::Clock::now();
+    auto message = makeMessage(3000);
+    auto fragments = split(message, 7, 1000);
+
+    EXPECT_EQ(reassembler.add(peer, fragments[2], now), nullptr);
+    EXPECT_EQ(reassembler.add(peer, fragments[0], now), nullptr);
+    EXPECT_EQ(reassembler.add(peer, fragments[0], now), nullptr);
+    const auto* whole = reassembler.add(peer, fragments[1], now);
+
+    ASSERT_NE(whole, nullptr);
+    EXPECT_EQ(*whole, message);
+    EXPECT_EQ(reassembler.pending(), 0u);
+}
+
+TEST(ReassemblerTest, KeepsPeersApart) {
+    Reassembler reassembler;
+    Endpoint a("127.0.0.1", 1000);
+    Endpoint b("127.0.0.1", 1001);
+    auto now = Reassembler::Clock::now();
+    auto message = makeMessage(200);
+    auto fragments = split(message, 1, 100);
+
+    EXPECT_EQ(reassembler.add(a, fragments[0], now), nullptr);
+    EXPECT_EQ(reassembler.add(b, fragments[1], now), nullptr);
+    EXPECT_EQ(reassembler.pending(), 2u);
+    EXPECT_NE(reassembler.add(a, fragments[1], now), nullptr);
+}
+
+TEST(ReassemblerTest, DropsIncompleteMessagesAfterTimeout) {
+    Reassembler reassembler;
+    Endpoint peer("127.0.0.1", 4242);
+    auto now = Reassembler::Clock::now();
+    auto message = makeMessage(200);
+    auto fragments = split(message, 3, 100);
+
+    reassembler.add(peer, fragments[0], now);
+    reassembler.expire(now + Reassembler::TIMEOUT);
+
+    EXPECT_EQ(reassembler.pending(), 0u);
+    EXPECT_EQ(reassembler.takeDropped(), 1u);
+    EXPECT_EQ(reassembler.add(peer, fragments[1], now + Reassembler::TIMEOUT), nullptr);
+}
+
+TEST(ReassemblerTest, EvictsOldestWhenFull) {
+    Reassembler reassembler;
+    Endpoint peer("127.0.0.1", 4242);
+    auto start = Reassembler::Clock::now();
+    auto message = makeMessage(200);
+
+    for (uint16_t id = 0; id <= Reassembler::MAX_PARTIALS; ++id)
+        reassembler.add(peer, split(message, id, 100)[0], start + std::chrono::milliseconds(id));
+
+    EXPECT_EQ(reassembler.pending(), Reassembler::MAX_PARTIALS);
+    EXPECT_EQ(reassembler.takeDropped(), 1u);
+    // Message 0 was evicted; message 1 is still there to be completed.
+    EXPECT_NE(reassembler.add(peer, split(message, 1, 100)[1], start + std::chrono::milliseconds(40)), nullptr);
+    EXPECT_EQ(reassembler.add(peer, split(message, 0, 100)[1], start + std::chrono::milliseconds(40)), nullptr);
+    EXPECT_EQ(reassembler.takeDropped(), 0u);
+}
+
+TEST(ReassemblerTest, RejectsMalformedFragments) {
+    Reassembler reassembler;
+    Endpoint peer("127.0.0.1", 4242);
+    auto now = Reassembler::Clock::now();
+    uint8_t bytes[16] = {};
+
+    EXPECT_EQ(reassembler.add(peer, Reassembler::Fragment{1, 2, 2, 32, 16, bytes, 16}, now), nullptr);
+    EXPECT_EQ(reassembler.add(peer, Reassembler::Fragment{1, 0, 2, 32, 24, bytes, 16}, now), nullptr);
+    EXPECT_EQ(reassembler.add(peer, Reassembler::Fragment{1, 0, 1, Reassembler::MAX_MESSAGE_SIZE + 1, 0, bytes, 16}, now), nullptr);
+    EXPECT_EQ(reassembler.pending(), 0u);
+    EXPECT_EQ(reassembler.takeDropped(), 3u);
+}
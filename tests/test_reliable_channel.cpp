@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include "network/ReliableChannel.hpp"
+#include "protocol/Protocol.hpp"
+#include <vector>
+
+using RType::Network::AckWindow;
+using RType::Network::SequenceWindow;
+using RType::Network::forEachAcked;
+
+namespace {
+
+std::vector<uint16_t> acked(const AckWindow& window)
+{
+    std::vector<uint16_t> sequences;
+    forEachAcked(window.ack, window.bits, [&](uint16_t sequence) { sequences.push_back(sequence); });
+    return sequences;
+}
+
+}
+
+TEST(AckWindowTest, TracksNewestAndPreceding) {
+    AckWindow window;
+    EXPECT_TRUE(window.record(10));
+    EXPECT_TRUE(window.record(11));
+    EXPECT_TRUE(window.record(13));
+
+    EXPECT_EQ(window.ack, 13);
+    EXPECT_EQ(acked(window), (std::vector<uint16_t>{13, 11, 10}));
+}
+
+TEST(AckWindowTest, LateArrivalFillsItsBit) {
+    AckWindow window;
+    window.record(20);
+    window.record(18);
+
+    EXPECT_EQ(window.ack, 20);
+    EXPECT_EQ(acked(window), (std::vector<uint16_t>{20, 18}));
+}
+
+TEST(AckWindowTest, RejectsSequencesOlderThanTheWindow) {
+    AckWindow window;
+    window.record(100);
+    EXPECT_TRUE(window.record(100 - AckWindow::SPAN));
+    EXPECT_FALSE(window.record(100 - AckWindow::SPAN - 1));
+}
+
+TEST(AckWindowTest, WrapsAroundSequenceSpace) {
+    AckWindow window;
+    window.record(65535);
+    window.record(1);
+
+    EXPECT_EQ(window.ack, 1);
+    EXPECT_EQ(acked(window), (std::vector<uint16_t>{1, 65535}));
+}
+
+TEST(AckWindowTest, RidesInPacketHeader) {
+    AckWindow window;
+    window.record(5);
+    window.record(6);
+
+    RType::Protocol::PacketHeader header;
+    EXPECT_FALSE(header.hasAcks());
+    header.setReliable(true);
+    header.setAcks(window.ack, window.bits);
+
+    EXPECT_TRUE(header.hasAcks());
+    EXPECT_TRUE(header.isReliable());
+    EXPECT_EQ(header.ack, 6);
+    EXPECT_EQ(header.ack_bits, 1u);
+}
+
+using RType::Network::RttEstimator;
+using std::chrono::milliseconds;
+
+TEST(RttEstimatorTest, FirstSampleSeedsEstimate) {
+    RttEstimator rtt;
+    EXPECT_EQ(rtt.rto, RttEstimator::INITIAL_RTO);
+
+    rtt.sample(milliseconds(40));
+    EXPECT_EQ(rtt.srtt, milliseconds(40));
+    EXPECT_EQ(rtt.rttvar, milliseconds(20));
+    EXPECT_EQ(rtt.rto, milliseconds(40 + 80) + AckWindow::FLUSH_DELAY);
+}
+
+TEST(RttEstimatorTest, SteadyLanLinkGetsFloorTimeout) {
+    RttEstimator rtt;
+    for (int i = 0; i < 50; ++i)
+        rtt.sample(std::chrono::microseconds(500));
+
+    EXPECT_EQ(rtt.rto, RttEstimator::MIN_RTO);
+}
+
+TEST(RttEstimatorTest, SlowLinkStretchesTimeout) {
+    RttEstimator rtt;
+    for (int i = 0; i < 50; ++i)
+        rtt.sample(milliseconds(250));
+
+    EXPECT_GT(rtt.rto, milliseconds(250));
+}
+
+TEST(RttEstimatorTest, BackoffDoublesUpToCap) {
+    RttEstimator rtt;
+    rtt.sample(milliseconds(100));
+    auto before = rtt.rto;
+    auto now = std::chrono::steady_clock::now();
+    rtt.backoff(now);
+    EXPECT_EQ(rtt.rto, before * 2);
+
+    for (int i = 0; i < 10; ++i) {
+        now += rtt.rto;
+        rtt.backoff(now);
+    }
+    EXPECT_EQ(rtt.rto, RttEstimator::MAX_RTO);
+}
+
+TEST(RttEstimatorTest, BurstOfTimeoutsBacksOffOnce) {
+    RttEstimator rtt;
+    rtt.sample(milliseconds(100));
+    auto before = rtt.rto;
+    auto now = std::chrono::steady_clock::now();
+    for (int i = 0; i < 8; ++i)
+        rtt.backoff(now + milliseconds(i));
+    EXPECT_EQ(rtt.rto, before * 2);
+
+    // A new sample ends the loss event.
+    rtt.sample(milliseconds(100));
+    before = rtt.rto;
+    rtt.backoff(now + milliseconds(10));
+    EXPECT_EQ(rtt.rto, before * 2);
+}
+
+TEST(SequenceWindowTest, DetectsDuplicates) {
+    SequenceWindow window;
+    EXPECT_FALSE(window.contains(5));
+    window.insert(5);
+    window.insert(7);
+
+    EXPECT_TRUE(window.contains(5));
+    EXPECT_FALSE(window.contains(6));
+    EXPECT_TRUE(window.contains(7));
+    EXPECT_FALSE(window.contains(8));
+}
+
+TEST(SequenceWindowTest, SlidingForgetsReusedSlots) {
+    SequenceWindow window;
+    window.insert(10);
+    window.insert(10 + SequenceWindow::SIZE - 1);
+
+    EXPECT_TRUE(window.contains(10));
+    // Shares its slot with 10, which has now slid out of the window.
+    window.insert(10 + SequenceWindow::SIZE + 1);
+    EXPECT_FALSE(window.contains(10 + SequenceWindow::SIZE));
+}
+
+TEST(SequenceWindowTest, TreatsTooOldAsSeen) {
+    SequenceWindow window;
+    window.insert(1000);
+
+    EXPECT_FALSE(window.contains(1000 - SequenceWindow::SIZE + 1));
+    EXPECT_TRUE(window.contains(1000 - SequenceWindow::SIZE));
+}
+
+TEST(SequenceWindowTest, WrapsAround) {
+    SequenceWindow window;
+    window.insert(65530);
+    window.insert(3);
+
+    EXPECT_TRUE(window.contains(65530));
+    EXPECT_FALSE(window.contains(65535));
+    EXPECT_FALSE(window.contains(0));
+    EXPECT_TRUE(window.contains(3));
+
+    window.insert(0);
+    EXPECT_TRUE(window.contains(0));
+    EXPECT_EQ(window.newest, 3);
+}
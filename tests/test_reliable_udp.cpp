@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "network/ReliableUDP.hpp"
+#include <vector>
+
+using RType::Network::ReliableUDP;
+
+namespace {
+
+// Feeds one-byte messages whose content is their sequence number and
+// records the order they come out in.
+struct OrderedStream {
+    void receive(uint16_t sequence, ReliableUDP::Clock::time_point now = ReliableUDP::Clock::time_point())
+    {
+        auto byte = static_cast<uint8_t>(sequence);
+        channel.receive(sequence, &byte, 1, now,
+                        [this](const uint8_t* data, size_t) { delivered.push_back(data[0]); });
+    }
+
+    ReliableUDP channel;
+    std::vector<uint8_t> delivered;
+};
+
+}
+
+TEST(ReliableUDPTest, HoldsBackUntilGapIsFilled) {
+    OrderedStream stream;
+    stream.receive(0);
+    stream.receive(2);
+    stream.receive(3);
+
+    EXPECT_EQ(stream.delivered, (std::vector<uint8_t>{0}));
+    EXPECT_EQ(stream.channel.buffered(), 2u);
+
+    stream.receive(1);
+    EXPECT_EQ(stream.delivered, (std::vector<uint8_t>{0, 1, 2, 3}));
+    EXPECT_EQ(stream.channel.buffered(), 0u);
+}
+
+TEST(ReliableUDPTest, DropsDuplicates) {
+    OrderedStream stream;
+    stream.receive(0);
+    stream.receive(0);
+    stream.receive(2);
+    stream.receive(2);
+    stream.receive(1);
+
+    EXPECT_EQ(stream.delivered, (std::vector<uint8_t>{0, 1, 2}));
+}
+
+TEST(ReliableUDPTest, SkipsGapWhenBufferFills) {
+    OrderedStream stream;
+    for (uint16_t sequence = 1; sequence <= ReliableUDP::MAX_BUFFERED; ++sequence)
+        stream.receive(sequence);
+
+    ASSERT_EQ(stream.delivered.size(), ReliableUDP::MAX_BUFFERED);
+    EXPECT_EQ(stream.delivered.front(), 1);
+    EXPECT_EQ(stream.channel.expectedSequence(), ReliableUDP::MAX_BUFFERED + 1);
+}
+
+TEST(ReliableUDPTest, SkipsGapAfterTimeout) {
+    OrderedStream stream;
+    ReliableUDP::Clock::time_point start;
+    stream.receive(1, start);
+    stream.receive(2, start + ReliableUDP::GAP_TIMEOUT / 2);
+    EXPECT_TRUE(stream.delivered.empty());
+
+    stream.receive(3, start + ReliableUDP::GAP_TIMEOUT);
+    EXPECT_EQ(stream.delivered, (std::vector<uint8_t>{1, 2, 3}));
+}
+
+TEST(ReliableUDPTest, OrdersAcrossSequenceWrap) {
+    OrderedStream stream;
+    for (uint16_t sequence = 0; sequence < 0xFFFF; ++sequence)
+        stream.receive(sequence);
+    stream.delivered.clear();
+
+    stream.receive(0);
+    stream.receive(0xFFFF);
+    EXPECT_EQ(stream.delivered, (std::vector<uint8_t>{0xFF, 0}));
+}
+
+TEST(ReliableUDPTest, PollSkipsGapWithoutNewArrivals) {
+    OrderedStream stream;
+    ReliableUDP::Clock::time_point start;
+    stream.receive(1, start);
+    stream.receive(2, start);
+    EXPECT_EQ(stream.channel.gapDeadline(), start + ReliableUDP::GAP_TIMEOUT);
+
+    auto deliver = [&](const uint8_t* data, size_t) { stream.delivered.push_back(data[0]); };
+    stream.channel.poll(start + ReliableUDP::GAP_TIMEOUT / 2, deliver);
+    EXPECT_TRUE(stream.delivered.empty());
+
+    stream.channel.poll(start + ReliableUDP::GAP_TIMEOUT, deliver);
+    EXPECT_EQ(stream.delivered, (std::vector<uint8_t>{1, 2}));
+    EXPECT_EQ(stream.channel.gapDeadline(), ReliableUDP::Clock::time_point::max());
+}
+
+TEST(ReliableUDPTest, SkipsToOldestAcrossSequenceWrap) {
+    OrderedStream stream;
+    for (uint16_t sequence = 0; sequence < 0xFFF0; ++sequence)
+        stream.receive(sequence);
+    stream.delivered.clear();
+
+    ReliableUDP::Clock::time_point start;
+    stream.receive(2, start);
+    stream.receive(0xFFF5, start);
+    stream.channel.poll(start + ReliableUDP::GAP_TIMEOUT,
+                        [&](const uint8_t* data, size_t) { stream.delivered.push_back(data[0]); });
+    EXPECT_EQ(stream.delivered, (std::vector<uint8_t>{0xF5}));
+    EXPECT_EQ(stream.channel.expectedSequence(), 0xFFF6);
+    EXPECT_EQ(stream.channel.buffered(), 1u);
+}
@@ -0,0 +1,464 @@
+#include <gtest/gtest.h>
+#include "Room.hpp"
+#include "Client.hpp"
+#include "network/BitStream.hpp"
+#include "network/Endpoint.hpp"
+#include "network/SnapshotCodec.hpp"
+#include <algorithm>
+#include <cstring>
+
+using namespace RType;
+
+namespace {
+
+class FakeNetwork : public Network::INetworkModule {
+public:
+    struct Sent {
+        uint32_t client_id;
+        std::vector<uint8_t> data;
+    };
+
+    bool start(uint16_t) override { return true; }
+    void stop() override {}
+    bool isRunning() const override { return true; }
+    void pollMessages(std::vector<Network::ReceivedMessage>& out) override { out.clear(); }
+
+    std::vector<uint32_t> getConnectedClients() const override {
+        std::vector<uint32_t> ids;
+        for (const auto& [id, client] : clients) {
+            ids.push_back(id);
+        }
+        return ids;
+    }
+    size_t getClientCount() const override { return clients.size(); }
+    void disconnectClient(uint32_t client_id) override { clients.erase(client_id); }
+
+    Network::ClientRegistration registerClient(const Network::Endpoint& addr, const std::string& name,
+                                               uint32_t room_id, uint8_t slot) override {
+        for (const auto& [id, client] : clients) {
+            if (client->getAddress() == addr) {
+                return {id, false, client->getRoomId()};
+            }
+        }
+        uint32_t id = nextId++;
+        auto client = std::make_shared<Server::Client>(id, addr, name, room_id);
+        client->setPlayerSlot(slot);
+        client->setState(Server::ClientState::CONNECTED);
+        clients[id] = client;
+        return {id, true, room_id};
+    }
+    void unregisterClient(uint32_t client_id) override { disconnectClient(client_id); }
+    std::vector<uint32_t> checkTimeouts(std::chrono::seconds) override { return {}; }
+    size_t getMtu() const override { return mtu; }
+
+    std::shared_ptr<Server::Client> getClient(uint32_t client_id) const override {
+        auto it = clients.find(client_id);
+        return it != clients.end() ? it->second : nullptr;
+    }
+    std::shared_ptr<Server::Client> getClientByAddress(
+        const Network::Endpoint& addr) const override {
+        if (lookupsMiss) {
+            return nullptr;
+        }
+        for (const auto& [id, client] : clients) {
+            if (client->getAddress() == addr) {
+                return client;
+            }
+        }
+        return nullptr;
+    }
+
+    std::map<uint32_t, std::shared_ptr<Server::Client>> clients;
+    std::vector<Sent> sent;
+    uint32_t nextId = 100;
+    size_t mtu = DEFAULT_MTU;
+    // Stands in for another room registering the address between a
+    // room's lookup and its registration.
+    bool lookupsMiss = false;
+
+protected:
+    void sendToClientRaw(uint32_t client_id, const void* data, size_t size) override {
+        auto bytes = static_cast<const uint8_t*>(data);
+        sent.push_back({client_id, std::vector<uint8_t>(bytes, bytes + size)});
+    }
+    void sendToAddressRaw(const Network::Endpoint&, const void* data, size_t size) override {
+        sendToClientRaw(0, data, size);
+    }
+    void broadcastRaw(const void*, size_t, uint32_t) override {}
+};
+
+Network::ReceivedMessage makeConnect(uint16_t port, uint32_t room_id, uint8_t capabilities = 0)
+{
+    Protocol::ConnectRequest request;
+    std::strncpy(request.player_name, "Tester", sizeof(request.player_name) - 1);
+    request.room_id = room_id;
+    request.capabilities = capabilities;
+
+    Network::ReceivedMessage msg;
+    msg.client_id = 0;
+    msg.source_addr = Network::Endpoint("127.0.0.1", port);
+    msg.packet_type = static_cast<uint8_t>(Protocol::PacketType::CONNECT_REQUEST);
+    msg.payload_size = sizeof(request);
+    msg.payload.assign(reinterpret_cast<uint8_t*>(&request),
+                       reinterpret_cast<uint8_t*>(&request) + sizeof(request));
+    return msg;
+}
+
+template<typename T>
+Network::ReceivedMessage makeMessage(uint32_t client_id, const T& packet)
+{
+    Network::ReceivedMessage msg;
+    msg.client_id = client_id;
+    msg.packet_type = static_cast<uint8_t>(packet.header.type);
+    msg.payload_size = sizeof(packet);
+    msg.payload.assign(reinterpret_cast<const uint8_t*>(&packet),
+                       reinterpret_cast<const uint8_t*>(&packet) + sizeof(packet));
+    return msg;
+}
+
+// Decodes sent into batch if it is a snapshot, decompressing it if needed.
+bool decodeSnapshot(const FakeNetwork::Sent& sent, Protocol::BatchedEntityUpdate& batch)
+{
+    Protocol::PacketHeader header;
+    if (sent.data.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, sent.data.data(), sizeof(header));
+    if (header.type != Protocol::PacketType::ENTITY_UPDATE) {
+        return false;
+    }
+    Network::EncodedPacket<sizeof(Protocol::BatchedEntityUpdate)> plain;
+    plain.size = sent.data.size();
+    std::memcpy(plain.bytes, sent.data.data(), sent.data.size());
+    if (header.isCompressed()) {
+        EXPECT_TRUE(Network::decompressBody(sent.data.data(), sent.data.size(), sizeof(header), plain));
+    }
+    EXPECT_TRUE(Network::decode(plain.bytes, plain.size, batch));
+    return true;
+}
+
+// The entity ids carried by each snapshot sent so far (to one client, if
+// given), in order.
+std::vector<std::pair<uint32_t, std::vector<uint32_t>>> snapshots(const FakeNetwork& network,
+                                                                  uint32_t client_id = 0)
+{
+    std::vector<std::pair<uint32_t, std::vector<uint32_t>>> out;
+    for (const auto& sent : network.sent) {
+        Protocol::BatchedEntityUpdate batch;
+        if ((client_id != 0 && sent.client_id != client_id) || !decodeSnapshot(sent, batch)) {
+            continue;
+        }
+        std::vector<uint32_t> ids;
+        for (uint16_t i = 0; i < batch.entity_count; ++i) {
+            ids.push_back(batch.entities[i].entity_id);
+        }
+        uint32_t tick = batch.tick;
+        out.emplace_back(tick, ids);
+    }
+    return out;
+}
+
+std::vector<Protocol::ConnectResponse> responses(const FakeNetwork& network)
+{
+    std::vector<Protocol::ConnectResponse> out;
+    for (const auto& sent : network.sent) {
+        Protocol::PacketHeader header;
+        std::memcpy(&header, sent.data.data(), sizeof(header));
+        if (header.type == Protocol::PacketType::CONNECT_RESPONSE) {
+            Protocol::ConnectResponse response;
+            std::memcpy(&response, sent.data.data(), sizeof(response));
+            out.push_back(response);
+        }
+    }
+    return out;
+}
+
+}
+
+TEST(RoomTest, AssignsRoomLocalPlayerIds) {
+    FakeNetwork network;
+    Server::Room room(7, network);
+
+    room.enqueue(makeConnect(5000, 7));
+    room.enqueue(makeConnect(5001, 7));
+    room.tick(1.0f / 60.0f);
+
+    auto replies = responses(network);
+    ASSERT_EQ(replies.size(), 2u);
+    EXPECT_EQ(replies[0].status, Protocol::ConnectionStatus::ACCEPTED);
+    EXPECT_EQ(replies[0].client_id, 1u);
+    EXPECT_EQ(replies[0].room_id, 7u);
+    EXPECT_EQ(replies[1].client_id, 2u);
+    EXPECT_EQ(replies[1].assigned_player_slot, 1);
+    EXPECT_EQ(room.getMemberCount(), 2u);
+    EXPECT_EQ(network.getClient(100)->getRoomId(), 7u);
+}
+
+TEST(RoomTest, LosesRegistrationRaceToAnotherRoom) {
+    FakeNetwork network;
+    Server::Room first(1, network);
+    Server::Room second(2, network);
+
+    first.enqueue(makeConnect(6100, 1));
+    first.tick(1.0f / 60.0f);
+    ASSERT_EQ(first.getMemberCount(), 1u);
+
+    network.lookupsMiss = true;
+    network.sent.clear();
+    second.enqueue(makeConnect(6100, 2));
+    second.tick(1.0f / 60.0f);
+
+    auto replies = responses(network);
+    ASSERT_EQ(replies.size(), 1u);
+    EXPECT_EQ(replies[0].status, Protocol::ConnectionStatus::REJECTED_NO_ROOM);
+    EXPECT_EQ(second.getMemberCount(), 0u);
+    EXPECT_EQ(network.getClient(100)->getRoomId(), 1u);
+}
+
+TEST(RoomTest, RejectsFifthPlayer) {
+    FakeNetwork network;
+    Server::Room room(1, network);
+
+    for (uint16_t i = 0; i < 5; ++i) {
+        room.enqueue(makeConnect(6000 + i, 1));
+    }
+    room.tick(1.0f / 60.0f);
+
+    auto replies = responses(network);
+    ASSERT_EQ(replies.size(), 5u);
+    EXPECT_EQ(replies[4].status, Protocol::ConnectionStatus::REJECTED_FULL);
+    EXPECT_EQ(room.getMemberCount(), 4u);
+}
+
+TEST(RoomTest, IdleOnlyWhenEmpty) {
+    FakeNetwork network;
+    Server::Room room(3, network);
+
+    EXPECT_TRUE(room.isIdle(std::chrono::seconds(-1)));
+
+    room.enqueue(makeConnect(7000, 3));
+    room.tick(1.0f / 60.0f);
+    EXPECT_FALSE(room.isIdle(std::chrono::seconds(-1)));
+}
+
+TEST(RoomTest, InboxIsBounded) {
+    FakeNetwork network;
+    Server::Room room(4, network);
+
+    room.enqueue(makeConnect(8000, 4));
+    room.tick(1.0f / 60.0f);
+
+    size_t accepted = 0;
+    Protocol::PlayerInput input;
+    for (uint16_t i = 0; i < 2000; ++i) {
+        if (room.enqueue(makeMessage(100, input))) {
+            ++accepted;
+        }
+    }
+    EXPECT_LT(accepted, 2000u);
+
+    room.tick(1.0f / 60.0f);
+    EXPECT_TRUE(room.enqueue(makeMessage(100, input)));
+}
+
+TEST(RoomTest, TimeoutFreesSlotEvenWhenInboxIsFull) {
+    FakeNetwork network;
+    Server::Room room(4, network);
+
+    room.enqueue(makeConnect(8000, 4));
+    room.tick(1.0f / 60.0f);
+    ASSERT_EQ(room.getMemberCount(), 1u);
+
+    Protocol::PlayerInput input;
+    while (room.enqueue(makeMessage(100, input))) {
+    }
+
+    // What Server::checkTimeouts sends once the client went quiet.
+    Protocol::DisconnectPacket timeout;
+    timeout.reason = 1;
+    EXPECT_TRUE(room.enqueue(makeMessage(100, timeout)));
+    EXPECT_TRUE(room.enqueue(makeConnect(8001, 4)));
+
+    room.tick(1.0f / 60.0f);
+    EXPECT_EQ(room.getMemberCount(), 1u);
+    EXPECT_EQ(network.clients.count(100), 0u);
+    EXPECT_EQ(network.clients.count(101), 1u);
+}
+
+TEST(RoomTest, SnapshotsRepeatUntilAcked) {
+    FakeNetwork network;
+    Server::Room room(5, network);
+
+    room.enqueue(makeConnect(9000, 5));
+    room.tick(1.0f / 60.0f);
+    Protocol::ReadyToPlay ready;
+    ready.ready = 1;
+    room.enqueue(makeMessage(100, ready));
+
+    room.tick(0.06f);
+    room.tick(0.06f);
+    auto sent = snapshots(network);
+    ASSERT_EQ(sent.size(), 2u);
+    ASSERT_FALSE(sent[0].second.empty());
+    EXPECT_EQ(sent[1].second, sent[0].second);
+
+    Protocol::SnapshotAck ack;
+    ack.tick = sent[1].first;
+    room.enqueue(makeMessage(100, ack));
+    network.sent.clear();
+    room.tick(0.06f);
+
+    sent = snapshots(network);
+    ASSERT_EQ(sent.size(), 1u);
+    // The idle player is in the acked baseline and is not repeated.
+    EXPECT_TRUE(sent[0].second.empty());
+}
+
+TEST(RoomTest, ResyncedEntityIsSentWhole) {
+    FakeNetwork network;
+    Server::Room room(7, network);
+
+    room.enqueue(makeConnect(9200, 7));
+    room.tick(1.0f / 60.0f);
+    Protocol::ReadyToPlay ready;
+    ready.ready = 1;
+    room.enqueue(makeMessage(100, ready));
+    room.tick(0.06f);
+    auto sent = snapshots(network);
+    ASSERT_EQ(sent.size(), 1u);
+    ASSERT_FALSE(sent[0].second.empty());
+    uint32_t player = sent[0].second[0];
+
+    Protocol::SnapshotAck ack;
+    ack.tick = sent[0].first;
+    room.enqueue(makeMessage(100, ack));
+    room.tick(0.06f);
+    sent = snapshots(network);
+    ASSERT_EQ(sent.size(), 2u);
+    ASSERT_TRUE(sent[1].second.empty());
+
+    // The client lost the state a later delta was based on.
+    Protocol::SnapshotAck resync;
+    resync.tick = sent[1].first;
+    ASSERT_TRUE(resync.addResync(player));
+    EXPECT_EQ(resync.getPacketSize(), Protocol::SnapshotAck::PREFIX_SIZE + sizeof(uint32_t));
+    Network::ReceivedMessage msg = makeMessage(100, resync);
+    msg.payload_size = resync.getPacketSize();
+    msg.payload.resize(msg.payload_size);
+    room.enqueue(msg);
+    network.sent.clear();
+    room.tick(0.06f);
+
+    Protocol::BatchedEntityUpdate batch;
+    bool decoded = false;
+    for (const auto& packet : network.sent) {
+        decoded = decoded || decodeSnapshot(packet, batch);
+    }
+    ASSERT_TRUE(decoded);
+    bool found = false;
+    for (uint16_t i = 0; i < batch.entity_count; ++i) {
+        if (batch.entities[i].entity_id == player) {
+            found = true;
+            EXPECT_EQ(batch.entities[i].change_mask, Protocol::CHANGED_ALL);
+            EXPECT_EQ(batch.entities[i].baseline_age, 0u);
+        }
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST(RoomTest, SnapshotsFitABundleWithinTheMtu) {
+    FakeNetwork network;
+    network.mtu = 300;
+    Server::Room room(8, network);
+
+    for (uint16_t port = 9300; port < 9304; ++port) {
+        room.enqueue(makeConnect(port, 8));
+    }
+    room.tick(1.0f / 60.0f);
+    Protocol::ReadyToPlay ready;
+    ready.ready = 1;
+    for (uint32_t id = 100; id < 104; ++id) {
+        room.enqueue(makeMessage(id, ready));
+    }
+    // Never acked, so the whole world competes for every snapshot.
+    for (int i = 0; i < 400; ++i) {
+        room.tick(0.06f);
+    }
+
+    size_t largest = 0;
+    for (const auto& sent : network.sent) {
+        Protocol::BatchedEntityUpdate batch;
+        if (decodeSnapshot(sent, batch)) {
+            largest = std::max(largest, sent.data.size());
+        }
+    }
+    // The budget was actually the limit.
+    EXPECT_GT(largest, network.mtu / 2);
+    EXPECT_LE(largest, network.mtu - sizeof(Protocol::BundleHeader) - Protocol::BundleHeader::ENTRY_PREFIX);
+}
+
+TEST(RoomTest, CompressesSnapshotsOnlyForClientsThatOfferIt) {
+    FakeNetwork network;
+    Server::Room room(6, network);
+
+    room.enqueue(makeConnect(9100, 6, Protocol::CAPABILITY_SNAPSHOT_COMPRESSION));
+    room.enqueue(makeConnect(9101, 6));
+    room.tick(1.0f / 60.0f);
+    auto accepted = responses(network);
+    ASSERT_EQ(accepted.size(), 2u);
+    EXPECT_EQ(accepted[0].capabilities, Protocol::CAPABILITY_SNAPSHOT_COMPRESSION);
+    EXPECT_EQ(accepted[1].capabilities, 0);
+
+    Protocol::ReadyToPlay ready;
+    ready.ready = 1;
+    room.enqueue(makeMessage(100, ready));
+    room.enqueue(makeMessage(101, ready));
+    // Never acked, so every snapshot carries the whole, growing world.
+    for (int i = 0; i < 60; ++i) {
+        room.tick(0.06f);
+    }
+
+    size_t compressed = 0;
+    for (const auto& sent : network.sent) {
+        Protocol::PacketHeader header;
+        std::memcpy(&header, sent.data.data(), sizeof(header));
+        if (header.isCompressed()) {
+            EXPECT_EQ(sent.client_id, 100u);
+            ++compressed;
+        }
+    }
+    EXPECT_GT(compressed, 0u);
+    EXPECT_EQ(snapshots(network, 100), snapshots(network, 101));
+}
+
+TEST(RoomTest, SendsOneScoreUpdatePerClientPerSnapshot) {
+    FakeNetwork network;
+    Server::Room room(8, network);
+
+    room.enqueue(makeConnect(9200, 8));
+    room.enqueue(makeConnect(9201, 8));
+    room.tick(1.0f / 60.0f);
+    Protocol::ReadyToPlay ready;
+    ready.ready = 1;
+    room.enqueue(makeMessage(100, ready));
+    room.enqueue(makeMessage(101, ready));
+    room.tick(0.06f);
+    network.sent.clear();
+    room.tick(0.06f);
+
+    std::map<uint32_t, size_t> updates;
+    for (const auto& sent : network.sent) {
+        Protocol::PacketHeader header;
+        std::memcpy(&header, sent.data.data(), sizeof(header));
+        if (header.type != Protocol::PacketType::SCORE_UPDATE) {
+            continue;
+        }
+        Protocol::ScoreUpdate update;
+        ASSERT_TRUE(Network::decode(sent.data.data(), sent.data.size(), update));
+        EXPECT_EQ(update.num_players, 2);
+        ++updates[sent.client_id];
+    }
+    ASSERT_EQ(updates.size(), 2u);
+    EXPECT_EQ(updates[100], snapshots(network, 100).size());
+    EXPECT_EQ(updates[101], snapshots(network, 101).size());
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "core/SnapshotBaseline.hpp"
+#include <vector>
+
+using Baseline = RType::Core::SnapshotBaseline<int>;
+
+namespace {
+
+std::vector<uint32_t> known(const Baseline& baseline)
+{
+    std::vector<uint32_t> ids;
+    baseline.forEachKnown([&](uint32_t id) { ids.push_back(id); });
+    return ids;
+}
+
+}
+
+TEST(SnapshotBaselineTest, NothingConfirmedUntilAcked) {
+    Baseline baseline;
+    baseline.begin(1);
+    baseline.sent(7, 42);
+
+    EXPECT_EQ(baseline.baseline(7), nullptr);
+    EXPECT_EQ(known(baseline), std::vector<uint32_t>{7});
+
+    baseline.acknowledge(1);
+    ASSERT_NE(baseline.baseline(7), nullptr);
+    EXPECT_EQ(*baseline.baseline(7), 42);
+}
+
+TEST(SnapshotBaselineTest, LostSnapshotKeepsOlderBaseline) {
+    Baseline baseline;
+    baseline.begin(1);
+    baseline.sent(7, 10);
+    baseline.acknowledge(1);
+
+    baseline.begin(2);
+    baseline.sent(7, 20);   // never acked
+    baseline.begin(3);
+    baseline.sent(7, 30);
+
+    EXPECT_EQ(*baseline.baseline(7), 10);
+    baseline.acknowledge(3);
+    EXPECT_EQ(*baseline.baseline(7), 30);
+}
+
+TEST(SnapshotBaselineTest, IgnoresStaleAndUnknownAcks) {
+    Baseline baseline;
+    baseline.begin(1);
+    baseline.sent(7, 10);
+    baseline.begin(2);
+    baseline.sent(7, 20);
+
+    baseline.acknowledge(2);
+    baseline.acknowledge(1);    // arrived late
+    EXPECT_EQ(*baseline.baseline(7), 20);
+
+    baseline.acknowledge(99);   // never sent
+    EXPECT_EQ(*baseline.baseline(7), 20);
+}
+
+TEST(SnapshotBaselineTest, AckedRemovalForgetsEntity) {
+    Baseline baseline;
+    baseline.begin(1);
+    baseline.sent(7, 10);
+    baseline.acknowledge(1);
+
+    baseline.begin(2);
+    baseline.removed(7);
+    EXPECT_EQ(known(baseline), std::vector<uint32_t>{7});
+
+    baseline.acknowledge(2);
+    EXPECT_TRUE(known(baseline).empty());
+    EXPECT_EQ(baseline.baseline(7), nullptr);
+}
+
+TEST(SnapshotBaselineTest, EvictedSnapshotCannotBeAcked) {
+    Baseline baseline;
+    baseline.begin(1);
+    baseline.sent(7, 10);
+    baseline.begin(1 + Baseline::HISTORY);
+    baseline.sent(8, 20);
+
+    baseline.acknowledge(1);
+    EXPECT_EQ(baseline.baseline(7), nullptr);
+    baseline.acknowledge(1 + Baseline::HISTORY);
+    EXPECT_EQ(*baseline.baseline(8), 20);
+}
+
+TEST(SnapshotBaselineTest, GivesUpOnRemovalNeverAcked) {
+    Baseline baseline;
+    baseline.begin(0);
+    baseline.sent(7, 10);
+    for (uint32_t tick = 1; tick <= Baseline::HISTORY; ++tick) {
+        baseline.begin(tick);
+        baseline.removed(7);
+    }
+    EXPECT_EQ(baseline.knownCount(), 0u);
+}
+
+TEST(SnapshotBaselineTest, PendingUntilLatestSendAcked) {
+    Baseline baseline;
+    baseline.begin(1);
+    baseline.sent(7, 10);
+    baseline.acknowledge(1);
+    EXPECT_FALSE(baseline.find(7).pending);
+    EXPECT_EQ(baseline.find(7).baselineTick, 1u);
+
+    baseline.begin(2);
+    baseline.sent(7, 20);
+    baseline.begin(3);
+    baseline.sent(7, 10);   // back to the baseline value
+
+    // The client may hold 20: it still needs telling.
+    baseline.acknowledge(2);
+    EXPECT_TRUE(baseline.find(7).pending);
+    EXPECT_EQ(baseline.find(7).baselineTick, 2u);
+
+    baseline.acknowledge(3);
+    EXPECT_FALSE(baseline.find(7).pending);
+    EXPECT_EQ(*baseline.find(7).baseline, 10);
+}
+
+TEST(SnapshotBaselineTest, ResyncDropsBaselineUntilNextAck) {
+    Baseline baseline;
+    baseline.begin(1);
+    baseline.sent(7, 10);
+    baseline.acknowledge(1);
+    ASSERT_NE(baseline.baseline(7), nullptr);
+
+    baseline.resync(7);
+    EXPECT_EQ(baseline.baseline(7), nullptr);
+    EXPECT_TRUE(baseline.find(7).pending);
+    EXPECT_EQ(baseline.knownCount(), 1u);
+
+    baseline.begin(2);
+    baseline.sent(7, 20);
+    baseline.acknowledge(2);
+    EXPECT_EQ(*baseline.baseline(7), 20);
+}
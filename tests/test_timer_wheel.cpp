@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "core/TimerWheel.hpp"
+#include <algorithm>
+
+using RType::Core::TimerWheel;
+using std::chrono::milliseconds;
+
+namespace {
+
+std::vector<uint64_t> advanceTo(TimerWheel& wheel, TimerWheel::Clock::time_point now)
+{
+    std::vector<uint64_t> fired;
+    wheel.advance(now, [&](uint64_t payload) { fired.push_back(payload); });
+    return fired;
+}
+
+}
+
+TEST(TimerWheelTest, FiresAtDeadlineNotBefore) {
+    auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(64, milliseconds(1), start);
+    wheel.schedule(start + milliseconds(10), 7);
+
+    EXPECT_TRUE(advanceTo(wheel, start + milliseconds(9)).empty());
+    EXPECT_EQ(advanceTo(wheel, start + milliseconds(10)), std::vector<uint64_t>{7});
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, CancelledTimerNeverFires) {
+    auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(64, milliseconds(1), start);
+    auto handle = wheel.schedule(start + milliseconds(5), 1);
+    wheel.schedule(start + milliseconds(5), 2);
+
+    EXPECT_TRUE(wheel.cancel(handle));
+    EXPECT_FALSE(wheel.cancel(handle));
+    EXPECT_EQ(advanceTo(wheel, start + milliseconds(5)), std::vector<uint64_t>{2});
+}
+
+TEST(TimerWheelTest, DeadlinesBeyondOneRevolutionWaitTheirRound) {
+    auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(16, milliseconds(1), start);
+    wheel.schedule(start + milliseconds(40), 3);
+
+    for (int ms = 1; ms < 40; ++ms) {
+        EXPECT_TRUE(advanceTo(wheel, start + milliseconds(ms)).empty()) << ms;
+    }
+    EXPECT_EQ(advanceTo(wheel, start + milliseconds(40)), std::vector<uint64_t>{3});
+}
+
+TEST(TimerWheelTest, StallFiresEverythingOverdue) {
+    auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(16, milliseconds(1), start);
+    wheel.schedule(start + milliseconds(3), 1);
+    wheel.schedule(start + milliseconds(50), 2);
+    wheel.schedule(start + milliseconds(500), 3);
+
+    auto fired = advanceTo(wheel, start + milliseconds(100));
+    std::sort(fired.begin(), fired.end());
+    EXPECT_EQ(fired, (std::vector<uint64_t>{1, 2}));
+    EXPECT_EQ(wheel.size(), 1u);
+}
+
+TEST(TimerWheelTest, CallbackMayReschedule) {
+    auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(64, milliseconds(1), start);
+    wheel.schedule(start + milliseconds(2), 9);
+
+    int fires = 0;
+    wheel.advance(start + milliseconds(2), [&](uint64_t payload) {
+        ++fires;
+        wheel.schedule(start + milliseconds(4), payload);
+    });
+    EXPECT_EQ(advanceTo(wheel, start + milliseconds(4)), std::vector<uint64_t>{9});
+    EXPECT_EQ(fires, 1);
+}
+
+TEST(TimerWheelTest, NextDeadlineIsTheEarliestPending) {
+    auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(16, milliseconds(1), start);
+    EXPECT_EQ(wheel.nextDeadline(), TimerWheel::Clock::time_point::max());
+
+    // Same slot, a later round: must not shadow the nearer timer.
+    wheel.schedule(start + milliseconds(37), 1);
+    EXPECT_EQ(wheel.nextDeadline(), start + milliseconds(37));
+    auto near = wheel.schedule(start + milliseconds(5), 2);
+    wheel.schedule(start + milliseconds(21), 3);
+    EXPECT_EQ(wheel.nextDeadline(), start + milliseconds(5));
+
+    wheel.cancel(near);
+    EXPECT_EQ(wheel.nextDeadline(), start + milliseconds(21));
+    advanceTo(wheel, start + milliseconds(21));
+    EXPECT_EQ(wheel.nextDeadline(), start + milliseconds(37));
+}